@@ -0,0 +1,680 @@
+/*** nmbench.c -- throughput of checkers, dispatcher and CLI
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if defined HAVE_CONFIG_H
+# include "config.h"
+#endif	/* HAVE_CONFIG_H */
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "numchk.h"
+#include "nifty.h"
+
+/* spend at least this many nanoseconds per round and measurement */
+#define MIN_ROUND_NS	(50000000U)
+/* result column size for batch runs */
+#define BATCH_NRES	(65536U)
+
+extern char **environ;
+
+/* a corpus, lines laid out Arrow-style like nmck_classify_batch() wants */
+struct corp_s {
+	const char *name;
+	char *buf;
+	int32_t *off;
+	size_t n;
+};
+
+/* one measurement */
+struct meas_s {
+	char bench[64U];
+	char corpus[256U];
+	size_t n;
+	size_t nb;
+	double ns;
+	double mbps;
+};
+
+static unsigned int nrounds = 5U;
+static FILE *outf;
+
+
+static __attribute__((format(printf, 1, 2))) void
+error(const char *fmt, ...)
+{
+	va_list vap;
+	va_start(vap, fmt);
+	vfprintf(stderr, fmt, vap);
+	va_end(vap);
+	if (errno) {
+		fputs(": ", stderr);
+		fputs(strerror(errno), stderr);
+	}
+	fputc('\n', stderr);
+	return;
+}
+
+static inline uint64_t
+now_ns(void)
+{
+	struct timespec tsp;
+
+	clock_gettime(CLOCK_MONOTONIC, &tsp);
+	return (uint64_t)tsp.tv_sec * 1000000000U + tsp.tv_nsec;
+}
+
+static uint64_t
+rnd(void)
+{
+/* xorshift64*, fixed seed so mixes are reproducible */
+	static uint64_t x = 0x9e3779b97f4a7c15ULL;
+
+	x ^= x >> 12U;
+	x ^= x << 25U;
+	x ^= x >> 27U;
+	return x * 0x2545f4914f6cdd1dULL;
+}
+
+/* all checkers and formatters by type */
+static nmck_t(*const nmck[NMCK_NTYPES])(const char*, size_t) = {
+#define NMCK_TYPE(x)	[NMCK_##x] = nmck_##x,
+	NMCK_TYPES(NMCK_TYPE)
+#undef NMCK_TYPE
+};
+
+static size_t(*const nmfmt[NMCK_NTYPES])(char*, nmck_t, const char*, size_t) = {
+#define NMCK_TYPE(x)	[NMCK_##x] = nmfmt_##x,
+	NMCK_TYPES(NMCK_TYPE)
+#undef NMCK_TYPE
+};
+
+
+/* corpora */
+static int
+corp_load(struct corp_s *restrict c, const char *fn)
+{
+	size_t bsz = 0U, bcap = 0U;
+	size_t n = 0U, ncap = 0U;
+	char *buf = NULL;
+	int32_t *off = NULL;
+	ssize_t nrd;
+	int fd;
+
+	if ((fd = open(fn, O_RDONLY)) < 0) {
+		return -1;
+	}
+	for (;;) {
+		if (bsz >= bcap) {
+			bcap = (bcap * 2U) ?: (1U << 20U);
+			if (UNLIKELY((buf = realloc(buf, bcap)) == NULL)) {
+				close(fd);
+				goto nomem;
+			}
+		}
+		if ((nrd = read(fd, buf + bsz, bcap - bsz)) <= 0) {
+			break;
+		}
+		bsz += nrd;
+	}
+	close(fd);
+	if (nrd < 0 || bsz > INT32_MAX) {
+		free(buf);
+		return -1;
+	}
+
+	/* squeeze out line terminators and empty lines, record offsets */
+	with (size_t j = 0U) {
+		for (size_t i = 0U, eol; i < bsz; i = eol + 1U) {
+			const char *nl = memchr(buf + i, '\n', bsz - i);
+			size_t len;
+
+			eol = nl ? (size_t)(nl - buf) : bsz;
+			len = eol - i;
+			len -= len && buf[eol - 1U] == '\r';
+			if (!len) {
+				continue;
+			}
+			if (n + 2U > ncap) {
+				ncap = (ncap * 2U) ?: 4096U;
+				off = realloc(off, ncap * sizeof(*off));
+				if (UNLIKELY(off == NULL)) {
+					goto nomem;
+				}
+			}
+			memmove(buf + j, buf + i, len);
+			off[n++] = (int32_t)j;
+			j += len;
+		}
+		if (off == NULL && (off = malloc(sizeof(*off))) == NULL) {
+			goto nomem;
+		}
+		off[n] = (int32_t)j;
+	}
+
+	with (const char *bn = strrchr(fn, '/')) {
+		c->name = bn ? bn + 1U : fn;
+	}
+	c->buf = buf;
+	c->off = off;
+	c->n = n;
+	return 0;
+
+nomem:
+	free(buf);
+	free(off);
+	errno = ENOMEM;
+	return -1;
+}
+
+static void
+corp_free(struct corp_s *restrict c)
+{
+	free(c->buf);
+	free(c->off);
+	return;
+}
+
+static int
+gen(const struct corp_s *cs, size_t nc, size_t n)
+{
+/* print N lines, a third verbatim corpus lines, a third corpus lines with
+ * one digit or letter replaced and a third random digit strings */
+	size_t ntot = 0U;
+
+	for (size_t i = 0U; i < nc; i++) {
+		ntot += cs[i].n;
+	}
+	for (size_t i = 0U; i < n; i++) {
+		const unsigned int how = ntot ? rnd() % 3U : 2U;
+		char ln[256U];
+		size_t len;
+
+		if (how < 2U) {
+			size_t k = rnd() % ntot, c;
+
+			for (c = 0U; k >= cs[c].n; k -= cs[c++].n);
+			len = cs[c].off[k + 1U] - cs[c].off[k];
+			len = len < sizeof(ln) ? len : sizeof(ln) - 1U;
+			memcpy(ln, cs[c].buf + cs[c].off[k], len);
+			if (how && len) {
+				const size_t j = rnd() % len;
+
+				switch (ln[j]) {
+				case '0' ... '9':
+					ln[j] = (char)('0' + rnd() % 10U);
+					break;
+				case 'A' ... 'Z':
+					ln[j] = (char)('A' + rnd() % 26U);
+					break;
+				default:
+					break;
+				}
+			}
+		} else {
+			len = 8U + rnd() % 12U;
+			for (size_t j = 0U; j < len; j++) {
+				ln[j] = (char)('0' + rnd() % 10U);
+			}
+		}
+		ln[len++] = '\n';
+		if (UNLIKELY(fwrite(ln, 1, len, stdout) < len)) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/* measurements */
+static void
+meas_put(const struct meas_s *m)
+{
+	fprintf(outf, "{\"bench\": \"%s\", \"corpus\": \"%s\", \
+\"n\": %zu, \"bytes\": %zu, \"ns\": %.3f, \"mbps\": %.3f}\n",
+		m->bench, m->corpus, m->n, m->nb, m->ns, m->mbps);
+	return;
+}
+
+static void
+meas_fin(struct meas_s *restrict m, uint64_t best, size_t reps)
+{
+/* turn the best round of REPS passes into per-identifier figures */
+	const double t = (double)best / (double)reps;
+
+	m->ns = m->n ? t / (double)m->n : 0.;
+	m->mbps = t > 0. ? (double)m->nb * 1000. / t : 0.;
+	return;
+}
+
+#define MEASURE(m, body)						\
+	do {								\
+		uint64_t _best = UINT64_MAX;				\
+		size_t _reps = 1U;					\
+		/* calibrate repetitions, then take the best round */	\
+		for (uint64_t _t;; _reps *= 2U) {			\
+			_t = now_ns();					\
+			for (size_t _r = 0U; _r < _reps; _r++) {	\
+				body;					\
+			}						\
+			if ((_t = now_ns() - _t) >= MIN_ROUND_NS ||	\
+			    _reps >= (1U << 30U)) {			\
+				_best = _t;				\
+				break;					\
+			}						\
+		}							\
+		for (unsigned int _k = 1U; _k < nrounds; _k++) {	\
+			uint64_t _t = now_ns();				\
+			for (size_t _r = 0U; _r < _reps; _r++) {	\
+				body;					\
+			}						\
+			_t = now_ns() - _t;				\
+			_best = _t < _best ? _t : _best;		\
+		}							\
+		meas_fin(m, _best, _reps);				\
+	} while (0)
+
+static volatile nmck_t sink;
+
+static void
+bench_dispatch(struct meas_s *restrict m, const struct corp_s *c)
+{
+	struct nmck_result res[NMCK_NTYPES];
+
+	snprintf(m->bench, sizeof(m->bench), "dispatch");
+	MEASURE(m, {
+			for (size_t i = 0U; i < c->n; i++) {
+				sink = (nmck_t)nmck_classify(
+					c->buf + c->off[i],
+					c->off[i + 1U] - c->off[i], res);
+			}
+		});
+	return;
+}
+
+static void
+bench_batch(struct meas_s *restrict m, const struct corp_s *c)
+{
+	static struct nmck_result res[BATCH_NRES];
+	static int32_t roff[BATCH_NRES + 1U];
+
+	snprintf(m->bench, sizeof(m->bench), "dispatch-batch");
+	MEASURE(m, {
+			for (size_t i = 0U, k; i < c->n; i += k) {
+				/* at most as many strings as offsets */
+				const size_t n = c->n - i < BATCH_NRES
+					? c->n - i : BATCH_NRES;
+
+				k = nmck_classify_batch(
+					c->buf, c->off + i, n,
+					res, countof(res), roff);
+				sink = (nmck_t)k;
+			}
+		});
+	return;
+}
+
+static int
+bench_cli(struct meas_s *restrict m, const char *prog, const char *fn)
+{
+	char *const argv[] = {(char*)prog, NULL};
+	uint64_t best = UINT64_MAX;
+
+	snprintf(m->bench, sizeof(m->bench), "cli");
+	for (unsigned int k = 0U; k < nrounds; k++) {
+		posix_spawn_file_actions_t fa;
+		uint64_t t;
+		pid_t p;
+		int st;
+
+		posix_spawn_file_actions_init(&fa);
+		posix_spawn_file_actions_addopen(
+			&fa, STDIN_FILENO, fn, O_RDONLY, 0);
+		posix_spawn_file_actions_addopen(
+			&fa, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+		t = now_ns();
+		st = posix_spawn(&p, prog, &fa, NULL, argv, environ);
+		posix_spawn_file_actions_destroy(&fa);
+		if (st) {
+			errno = st;
+			return -1;
+		} else if (waitpid(p, &st, 0) < 0) {
+			return -1;
+		} else if (!WIFEXITED(st) || WEXITSTATUS(st)) {
+			errno = 0;
+			return -1;
+		}
+		t = now_ns() - t;
+		best = t < best ? t : best;
+	}
+	meas_fin(m, best, 1U);
+	return 0;
+}
+
+static void
+bench_types(const struct corp_s *cs, size_t nc)
+{
+/* every checker and formatter on the lines that classify as its type */
+	struct nmck_result res[NMCK_NTYPES];
+	struct item_s {
+		const char *str;
+		size_t len;
+		nmck_t st;
+	};
+	struct {
+		size_t n, ncap, nb;
+		struct item_s *it;
+	} ty[NMCK_NTYPES] = {{0U}};
+	size_t maxl = 0U;
+	char *fbuf;
+
+	/* pool the lines of all corpora */
+	for (size_t j = 0U; j < nc; j++) {
+		for (size_t i = 0U; i < cs[j].n; i++) {
+			const char *str = cs[j].buf + cs[j].off[i];
+			const size_t len = cs[j].off[i + 1U] - cs[j].off[i];
+			const size_t nr = nmck_classify(str, len, res);
+
+			maxl = len > maxl ? len : maxl;
+			for (size_t r = 0U; r < nr; r++) {
+				const nmck_type_t t = res[r].type;
+
+				if (ty[t].n >= ty[t].ncap) {
+					const size_t nu = (ty[t].ncap * 2U) ?: 256U;
+					struct item_s *it = realloc(
+						ty[t].it, nu * sizeof(*it));
+
+					if (UNLIKELY(it == NULL)) {
+						error("\
+error: cannot allocate items for %s", nmck_type_name(t));
+						goto out;
+					}
+					ty[t].it = it;
+					ty[t].ncap = nu;
+				}
+				ty[t].it[ty[t].n++] = (struct item_s){
+					str, len, res[r].state,
+				};
+				ty[t].nb += len;
+			}
+		}
+	}
+	if ((fbuf = malloc(maxl + NMFMT_SLACK)) == NULL) {
+		goto out;
+	}
+
+	for (nmck_type_t t = NMCK_UNK + 1U; t < NMCK_NTYPES; t++) {
+		const struct item_s *it = ty[t].it;
+		struct meas_s m = {.n = ty[t].n, .nb = ty[t].nb};
+
+		if (!ty[t].n) {
+			continue;
+		}
+		snprintf(m.corpus, sizeof(m.corpus), "*");
+
+		snprintf(m.bench, sizeof(m.bench), "nmck_%s", nmck_type_name(t));
+		MEASURE(&m, {
+				for (size_t i = 0U; i < m.n; i++) {
+					sink = nmck[t](it[i].str, it[i].len);
+				}
+			});
+		meas_put(&m);
+
+		snprintf(m.bench, sizeof(m.bench), "nmfmt_%s", nmck_type_name(t));
+		MEASURE(&m, {
+				for (size_t i = 0U; i < m.n; i++) {
+					sink = (nmck_t)nmfmt[t](
+						fbuf, it[i].st,
+						it[i].str, it[i].len);
+				}
+			});
+		meas_put(&m);
+	}
+	free(fbuf);
+out:
+	for (nmck_type_t t = NMCK_UNK; t < NMCK_NTYPES; t++) {
+		free(ty[t].it);
+	}
+	return;
+}
+
+
+/* baselines */
+static int
+meas_get(struct meas_s *restrict m, FILE *f)
+{
+	char *line = NULL;
+	size_t llen = 0U;
+	int rc = -1;
+
+	while (getline(&line, &llen, f) > 0) {
+		if (sscanf(line, "{\"bench\": \"%63[^\"]\", \"corpus\": \
+\"%255[^\"]\", \"n\": %zu, \"bytes\": %zu, \"ns\": %lf, \"mbps\": %lf}",
+			   m->bench, m->corpus,
+			   &m->n, &m->nb, &m->ns, &m->mbps) == 6) {
+			rc = 0;
+			break;
+		}
+	}
+	free(line);
+	return rc;
+}
+
+static int
+cmp_base(FILE *cur, const char *fn, double tol)
+{
+/* compare current results in CUR against baseline FN,
+ * return the number of regressions */
+	struct meas_s b, m;
+	FILE *f;
+	int nreg = 0;
+
+	if ((f = fopen(fn, "r")) == NULL) {
+		error("\
+warning: cannot open baseline `%s', not comparing", fn);
+		return 0;
+	}
+	rewind(cur);
+	while (meas_get(&m, cur) >= 0) {
+		rewind(f);
+		while (meas_get(&b, f) >= 0) {
+			if (strcmp(b.bench, m.bench) ||
+			    strcmp(b.corpus, m.corpus)) {
+				continue;
+			} else if (m.ns > b.ns * (1. + tol / 100.)) {
+				errno = 0;
+				error("\
+regression: %s on %s takes %.3fns/id, baseline %.3fns/id (+%.1f%%)",
+				      m.bench, m.corpus, m.ns, b.ns,
+				      (m.ns / b.ns - 1.) * 100.);
+				nreg++;
+			}
+			break;
+		}
+	}
+	fclose(f);
+	return nreg;
+}
+
+
+#include "nmbench.yucc"
+
+int
+main(int argc, char *argv[])
+{
+	yuck_t argi[1U];
+	struct corp_s *cs = NULL;
+	size_t nc = 0U;
+	FILE *res = NULL;
+	int rc = 0;
+
+	if (yuck_parse(argi, argc, argv) < 0) {
+		rc = 1;
+		goto out;
+	} else if (!argi->nargs) {
+		errno = 0;
+		error("\
+error: need at least one CORPUS");
+		rc = 1;
+		goto out;
+	} else if (argi->nargs > 256U) {
+		errno = 0;
+		error("\
+error: cannot handle more than 256 corpora");
+		rc = 1;
+		goto out;
+	}
+
+	if (argi->rounds_arg) {
+		long int nr = strtol(argi->rounds_arg, NULL, 0);
+
+		nrounds = nr > 0 ? (unsigned int)nr : 1U;
+	}
+
+	if ((cs = calloc(argi->nargs, sizeof(*cs))) == NULL) {
+		error("\
+error: cannot allocate corpora");
+		rc = 1;
+		goto out;
+	}
+	for (; nc < argi->nargs; nc++) {
+		if (corp_load(cs + nc, argi->args[nc]) < 0) {
+			error("\
+error: cannot read corpus `%s'", argi->args[nc]);
+			rc = 1;
+			goto out;
+		}
+	}
+
+	if (argi->generate_arg) {
+		const long int n = strtol(argi->generate_arg, NULL, 0);
+
+		if (n < 0 || gen(cs, nc, (size_t)n) < 0) {
+			error("\
+error: cannot generate mix");
+			rc = 1;
+		}
+		goto out;
+	}
+
+	/* collect results in a temp file so we can compare them later */
+	if ((outf = res = tmpfile()) == NULL) {
+		error("\
+error: cannot create temporary results file");
+		rc = 1;
+		goto out;
+	}
+	for (size_t j = 0U; j < nc; j++) {
+		struct meas_s m = {
+			.n = cs[j].n,
+			.nb = (size_t)cs[j].off[cs[j].n],
+		};
+
+		snprintf(m.corpus, sizeof(m.corpus), "%s", cs[j].name);
+		bench_dispatch(&m, cs + j);
+		meas_put(&m);
+		bench_batch(&m, cs + j);
+		meas_put(&m);
+		if (argi->cli_arg) {
+			struct stat st;
+
+			/* CLI throughput counts the file as it is */
+			if (stat(argi->args[j], &st) == 0) {
+				m.nb = st.st_size;
+			}
+			if (bench_cli(&m, argi->cli_arg, argi->args[j]) < 0) {
+				error("\
+error: running `%s' on `%s' failed", argi->cli_arg, argi->args[j]);
+				rc = 1;
+				continue;
+			}
+			meas_put(&m);
+		}
+	}
+	bench_types(cs, nc);
+	fflush(res);
+
+	/* copy results to where they belong */
+	with (FILE *of = stdout) {
+		char buf[4096U];
+		size_t nrd;
+
+		if (argi->output_arg &&
+		    (of = fopen(argi->output_arg, "w")) == NULL) {
+			error("\
+error: cannot open output file `%s'", argi->output_arg);
+			rc = 1;
+			break;
+		}
+		rewind(res);
+		while ((nrd = fread(buf, 1, sizeof(buf), res)) > 0) {
+			fwrite(buf, 1, nrd, of);
+		}
+		if (of != stdout) {
+			fclose(of);
+		}
+	}
+
+	if (argi->baseline_arg) {
+		const double tol = argi->tolerance_arg
+			? strtod(argi->tolerance_arg, NULL) : 25.;
+
+		if (cmp_base(res, argi->baseline_arg, tol) > 0) {
+			rc = 1;
+		}
+	}
+
+out:
+	if (res != NULL) {
+		fclose(res);
+	}
+	for (size_t j = 0U; j < nc; j++) {
+		corp_free(cs + j);
+	}
+	free(cs);
+	yuck_free(argi);
+	return rc;
+}
+
+/* nmbench.c ends here */
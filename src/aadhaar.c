@@ -40,7 +40,9 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static const uint_fast8_t d5[10U][10U] = {
 	[0] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
@@ -70,7 +72,7 @@ static const uint_fast8_t perm[8U][10U] = {
 %%{
 	machine numchk;
 
-	aadhaar = digit{4} " "? digit{4} " "? digit{3} (digit | check) %{c(aadhaar)} ;
+	aadhaar = digit{4} " "? digit{4} " "? digit{3} (digit | check) %{cd(aadhaar)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -111,18 +113,48 @@ nmck_aadhaar(const char *str, size_t len)
 	return prod << 1U ^ ((char)prod != str[len - 1U]);
 }
 
-void
-nmpr_aadhaar(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_aadhaar(const struct nmdg_s *dg, const char *str, size_t len)
+{
+	uint_fast8_t prod = dg->vp;
+
+	if (UNLIKELY(len < 12U || len > 14U)) {
+		return -1;
+	}
+	if (UNLIKELY(dg->d[0U] <= 1U)) {
+		/* not allowed */
+		return -1;
+	}
+	/* invert prod */
+	if (prod < 5U) {
+		prod = (uint_fast8_t)(5U - prod);
+		prod %= 5U;
+	}
+	prod ^= '0';
+	return prod << 1U ^ ((char)prod != str[len - 1U]);
+}
+
+size_t
+nmfmt_aadhaar(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("Aadhaar, conformant", stdout);
+		bp = fmt_lit(bp, "Aadhaar, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("Aadhaar, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "Aadhaar, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_aadhaar(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_aadhaar, s, str, len);
 	return;
 }
 
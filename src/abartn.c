@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -77,18 +78,27 @@ nmck_abartn(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_abartn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_abartn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("ABA RTN, conformant", stdout);
+		bp = fmt_lit(bp, "ABA RTN, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("ABA RTN, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "ABA RTN, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_abartn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_abartn, s, str, len);
 	return;
 }
 
@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 /* allowed BIC country codes */
 #include "bic-cc.c"
 
@@ -79,16 +80,26 @@ nmck_bic(const char *str, size_t len)
 	return len == 9 || len == 12U;
 }
 
-void
-nmpr_bic(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+size_t
+nmfmt_bic(char *restrict buf, nmck_t s,
+	  const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (!s) {
-		fputs("BIC, conformant with ISO 9362:2009", stdout);
+		bp = fmt_lit(bp, "BIC, conformant with ISO 9362:2009");
 	} else if (s > 0) {
-		fputs("FIN address, Swift conformant", stdout);
+		bp = fmt_lit(bp, "FIN address, Swift conformant");
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_bic(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_bic, s, str, len);
 	return;
 }
 
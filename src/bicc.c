@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static uint_fast32_t
 _calph(char x)
@@ -107,18 +108,27 @@ nmck_bicc(const char *str, size_t len)
 	return sum << 1U ^ sum != (unsigned char)str[10U];
 }
 
-void
-nmpr_bicc(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_bicc(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("BICC, conformant with ISO 6346:1995", stdout);
+		bp = fmt_lit(bp, "BICC, conformant with ISO 6346:1995");
 	} else if (s > 0 && len == 11U) {
-		fputs("BICC, not ISO 6346 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 10U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "BICC, not ISO 6346 conformant, should be ");
+		bp = fmt_mem(bp, str, 10U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_bicc(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_bicc, s, str, len);
 	return;
 }
 
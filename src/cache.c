@@ -0,0 +1,278 @@
+/*** cache.c -- persistent cache of classification results
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cache.h"
+#include "hash.h"
+#include "nifty.h"
+
+#define CACHE_MAGIC	"NMCKCACH"
+#define CACHE_VERSION	2U
+/* slots in a new cache file, the file is sparse */
+#define CACHE_NSLOT	(1U << 22U)
+/* slots to try before replacing the first one */
+#define CACHE_NPROBE	8U
+/* results per slot, inputs with more results aren't cached */
+#define CACHE_NRES	4U
+/* input bytes per slot, longer inputs aren't cached */
+#define CACHE_NKEY	72U
+
+struct hdr_s {
+	char magic[8U];
+	uint32_t vers;
+	uint32_t slotz;
+	uint64_t nslot;
+	char pad[40U];
+};
+
+/* two cache lines per slot, FP is written last and 0 for free slots,
+ * SUM covers everything after FP up to SUM, the input itself included,
+ * so hits are decided by the input and not by its fingerprint */
+struct slot_s {
+	uint64_t fp;
+	uint8_t nres;
+	uint8_t nsure;
+	uint8_t ty[CACHE_NRES];
+	uint8_t keyz;
+	uint8_t pad;
+	int64_t st[CACHE_NRES];
+	char key[CACHE_NKEY];
+	uint64_t sum;
+};
+
+#define CACHE_FILZ	(CACHE_NSLOT * sizeof(struct slot_s))
+
+struct cache_s {
+	void *map;
+	size_t mapz;
+	struct slot_s *slot;
+	uint64_t msk;
+	uint64_t salt;
+	int rdonly;
+};
+
+
+static inline uint64_t
+slot_sum(const struct slot_s *s)
+{
+	const size_t beg = offsetof(struct slot_s, nres);
+	const size_t end = offsetof(struct slot_s, sum);
+
+	return hash64((const char*)s + beg, end - beg, CACHE_VERSION);
+}
+
+static inline int
+slot_keyp(const struct slot_s *s, const char *str, size_t len)
+{
+	return s->keyz == len && !memcmp(s->key, str, len);
+}
+
+static int
+hdr_init(int fd, struct hdr_s *h)
+{
+	*h = (struct hdr_s){
+		.magic = CACHE_MAGIC,
+		.vers = CACHE_VERSION,
+		.slotz = sizeof(struct slot_s),
+		.nslot = CACHE_NSLOT,
+	};
+	if (ftruncate(fd, sizeof(*h) + CACHE_FILZ) < 0) {
+		return -1;
+	} else if (pwrite(fd, h, sizeof(*h), 0) < (ssize_t)sizeof(*h)) {
+		return -1;
+	}
+	return 0;
+}
+
+
+struct cache_s*
+cache_open(const char *fn, uint64_t salt)
+{
+	static const char nul[sizeof(CACHE_MAGIC) - 1U];
+	struct cache_s *c = NULL;
+	struct hdr_s h;
+	struct stat st;
+	int rdonly = 0;
+	void *mp;
+	int fd;
+
+	if ((fd = open(fn, O_RDWR | O_CREAT, 0666)) < 0) {
+		if ((fd = open(fn, O_RDONLY)) < 0) {
+			return NULL;
+		}
+		rdonly = 1;
+	}
+	if (fstat(fd, &st) < 0) {
+		goto clo;
+	} else if (!st.st_size ||
+		   ((size_t)st.st_size == sizeof(h) + CACHE_FILZ &&
+		    pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) &&
+		    !memcmp(h.magic, nul, sizeof(h.magic)))) {
+		/* new file, or one that's being set up as we speak */
+		if (rdonly || hdr_init(fd, &h) < 0) {
+			goto clo;
+		}
+	} else if ((size_t)st.st_size < sizeof(h) ||
+		   pread(fd, &h, sizeof(h), 0) < (ssize_t)sizeof(h)) {
+		goto clo;
+	} else if (memcmp(h.magic, CACHE_MAGIC, sizeof(h.magic)) ||
+		   h.vers != CACHE_VERSION ||
+		   h.slotz != sizeof(struct slot_s) ||
+		   !h.nslot || (h.nslot & (h.nslot - 1U))) {
+		goto clo;
+	}
+	if (fstat(fd, &st) < 0 ||
+	    (uint64_t)st.st_size < sizeof(h) + h.nslot * sizeof(struct slot_s)) {
+		goto clo;
+	}
+	mp = mmap(NULL, st.st_size, PROT_READ | (rdonly ? 0 : PROT_WRITE),
+		  MAP_SHARED, fd, 0);
+	if (mp == MAP_FAILED) {
+		goto clo;
+	} else if (UNLIKELY((c = malloc(sizeof(*c))) == NULL)) {
+		munmap(mp, st.st_size);
+		goto clo;
+	}
+	*c = (struct cache_s){
+		.map = mp,
+		.mapz = st.st_size,
+		.slot = (void*)((char*)mp + sizeof(h)),
+		.msk = h.nslot - 1U,
+		.salt = salt,
+		.rdonly = rdonly,
+	};
+clo:
+	close(fd);
+	return c;
+}
+
+void
+cache_close(struct cache_s *c)
+{
+	if (c == NULL) {
+		return;
+	}
+	munmap(c->map, c->mapz);
+	free(c);
+	return;
+}
+
+int
+cache_get(const struct cache_s *c, const char *str, size_t len,
+	  struct nmck_result *res)
+{
+	const uint64_t fp = hash64(str, len, c->salt) | 1U;
+
+	if (len > CACHE_NKEY) {
+		return -1;
+	}
+	for (size_t k = 0U; k < CACHE_NPROBE; k++) {
+		const struct slot_s *s = c->slot + ((fp + k) & c->msk);
+		const uint64_t f = __atomic_load_n(&s->fp, __ATOMIC_ACQUIRE);
+		struct slot_s x;
+
+		if (!f) {
+			return -1;
+		} else if (f != fp) {
+			continue;
+		}
+		memcpy(&x, s, sizeof(x));
+		if (UNLIKELY(x.sum != slot_sum(&x) ||
+			     x.nres > CACHE_NRES || x.nsure > x.nres)) {
+			/* torn by a concurrent writer */
+			return -1;
+		} else if (!slot_keyp(&x, str, len)) {
+			/* same fingerprint, different input */
+			continue;
+		}
+		for (size_t i = 0U; i < x.nres; i++) {
+			if (UNLIKELY(x.ty[i] >= NMCK_NTYPES)) {
+				return -1;
+			}
+			res[i].type = (nmck_type_t)x.ty[i];
+			res[i].state = (nmck_t)x.st[i];
+			res[i].sure = (unsigned char)(i < x.nsure);
+			nmck_decode(res + i, str, len);
+		}
+		return x.nres;
+	}
+	return -1;
+}
+
+void
+cache_put(struct cache_s *c, const char *str, size_t len,
+	  const struct nmck_result *res, size_t nres)
+{
+	const uint64_t fp = hash64(str, len, c->salt) | 1U;
+	struct slot_s x = {0U};
+	struct slot_s *s = c->slot + (fp & c->msk);
+
+	if (c->rdonly || nres > CACHE_NRES || len > CACHE_NKEY) {
+		return;
+	}
+	for (size_t k = 0U; k < CACHE_NPROBE; k++) {
+		struct slot_s *t = c->slot + ((fp + k) & c->msk);
+		const uint64_t f = __atomic_load_n(&t->fp, __ATOMIC_RELAXED);
+
+		if (!f || (f == fp && slot_keyp(t, str, len))) {
+			s = t;
+			break;
+		}
+	}
+	x.nres = (uint8_t)nres;
+	x.keyz = (uint8_t)len;
+	memcpy(x.key, str, len);
+	for (size_t i = 0U; i < nres; i++) {
+		x.ty[i] = (uint8_t)res[i].type;
+		x.st[i] = res[i].state;
+		x.nsure += res[i].sure;
+	}
+	x.sum = slot_sum(&x);
+	/* payload first, readers only look at it once FP matches */
+	memcpy((char*)s + sizeof(s->fp), (char*)&x + sizeof(x.fp),
+	       sizeof(x) - sizeof(x.fp));
+	__atomic_store_n(&s->fp, fp, __ATOMIC_RELEASE);
+	return;
+}
+
+/* cache.c ends here */
@@ -0,0 +1,72 @@
+/*** cache.h -- persistent cache of classification results
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_cache_h_
+#define INCLUDED_cache_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "numchk.h"
+
+/**
+ * Classification results keyed by the input and found through its
+ * fingerprint, kept in a file that is mapped shared, so runs and
+ * processes reuse each other's work.  Long inputs aren't cached.
+ * Readers take no locks, a slot being overwritten concurrently simply
+ * reads as a miss. */
+struct cache_s;
+
+/**
+ * Open or create the cache file FN, SALT distinguishes results of
+ * different classifier configurations.  Return NULL on failure. */
+extern struct cache_s *cache_open(const char *fn, uint64_t salt);
+
+extern void cache_close(struct cache_s*);
+
+/**
+ * Look up STR of length LEN, fill RES like nmck_classify() does and
+ * return the number of results, or -1 if STR is not cached. */
+extern int cache_get(
+	const struct cache_s*, const char *str, size_t len,
+	struct nmck_result *res);
+
+/**
+ * Remember the NRES results RES for STR of length LEN. */
+extern void cache_put(
+	struct cache_s*, const char *str, size_t len,
+	const struct nmck_result *res, size_t nres);
+
+#endif	/* INCLUDED_cache_h_ */
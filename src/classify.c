@@ -0,0 +1,479 @@
+/*** classify.c -- classification of strings
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdlib.h>
+#include <string.h>
+#include "numchk.h"
+#include "state.h"
+#include "nifty.h"
+
+/* the dispatchers, chck1() and its smaller siblings */
+#include "numchk.rlc"
+#include "numchk-fin.rlc"
+#include "numchk-tax.rlc"
+#include "numchk-pub.rlc"
+
+static int(*const chck[NMCK_NMACHS])(struct chck_s*, const char*, size_t) = {
+	[NMCK_MACH_FULL] = chck1,
+	[NMCK_MACH_FIN] = chck1_fin,
+	[NMCK_MACH_TAX] = chck1_tax,
+	[NMCK_MACH_PUB] = chck1_pub,
+};
+
+static const char *const mach_name[NMCK_NMACHS] = {
+	[NMCK_MACH_FULL] = "full",
+	[NMCK_MACH_FIN] = "financial",
+	[NMCK_MACH_TAX] = "tax",
+	[NMCK_MACH_PUB] = "publishing",
+};
+
+/* names and checkers by type */
+static const char *const nmck_name[NMCK_NTYPES] = {
+#define NMCK_TYPE(x)	[NMCK_##x] = #x,
+	NMCK_TYPES(NMCK_TYPE)
+#undef NMCK_TYPE
+};
+
+/* types the dispatchers never report, only their variants */
+static const nmck_type_t umbrella[NMCK_NTYPES] = {
+	[NMCK_isbn10] = NMCK_isbn,
+	[NMCK_isbn13] = NMCK_isbn,
+	[NMCK_issn8] = NMCK_issn,
+	[NMCK_issn13] = NMCK_issn,
+	[NMCK_ismn10] = NMCK_ismn,
+	[NMCK_ismn13] = NMCK_ismn,
+};
+
+/* incremental check digit algorithms */
+static const struct {
+	int(*feed)(struct nmck_state*, char);
+	int(*final)(const struct nmck_state*);
+} algo[NMCK_NALGOS] = {
+	[NMCK_ALGO_LUHN] = {luhn_feed, luhn_final},
+	[NMCK_ALGO_MOD10_31] = {gtin_feed, gtin_final},
+	[NMCK_ALGO_MOD11] = {isbn_feed, isbn_final},
+	[NMCK_ALGO_MOD97] = {mod97_feed, mod97_final},
+	[NMCK_ALGO_MOD97_ROT4] = {mod97_feed, mod97_final},
+	[NMCK_ALGO_DAMM10] = {damm10_feed, damm_final},
+	[NMCK_ALGO_DAMM16] = {damm16_feed, damm_final},
+	[NMCK_ALGO_VERHOEFF] = {verhoeff_feed, verhoeff_final},
+};
+
+/* check character positions, used to decode suggestions */
+static const struct {
+	/* offset of the first check character, negative counts from the end */
+	signed char off;
+	/* number of check characters */
+	unsigned char nchk;
+	/* bit offsets of the check characters in the checker state */
+	unsigned char shft[2U];
+} chkpos[NMCK_NTYPES] = {
+	[NMCK_aadhaar] = {-1, 1U, {1U}},
+	[NMCK_abartn] = {-1, 1U, {1U}},
+	[NMCK_bicc] = {-1, 1U, {1U}},
+	[NMCK_cas] = {-1, 1U, {1U}},
+	[NMCK_cusip] = {-1, 1U, {1U}},
+	[NMCK_figi] = {-1, 1U, {1U}},
+	[NMCK_grid] = {-1, 1U, {1U}},
+	[NMCK_idnr] = {-1, 1U, {1U}},
+	[NMCK_imei] = {-1, 1U, {1U}},
+	[NMCK_imo] = {-1, 1U, {1U}},
+	[NMCK_isin] = {-1, 1U, {1U}},
+	[NMCK_isni] = {-1, 1U, {1U}},
+	[NMCK_istc] = {-1, 1U, {1U}},
+	[NMCK_nhi] = {-1, 1U, {1U}},
+	[NMCK_nhs] = {-1, 1U, {1U}},
+	[NMCK_npi] = {-1, 1U, {1U}},
+	[NMCK_oib] = {-1, 1U, {1U}},
+	[NMCK_sedol] = {-1, 1U, {1U}},
+	[NMCK_devatid] = {-1, 1U, {1U}},
+	[NMCK_dkvatid] = {-1, 1U, {1U}},
+	[NMCK_fivatid] = {-1, 1U, {1U}},
+	[NMCK_grvatid] = {-1, 1U, {1U}},
+	[NMCK_ievatid] = {-1, 1U, {1U}},
+	[NMCK_itvatid] = {-1, 1U, {1U}},
+	[NMCK_atvatid] = {-1, 1U, {1U}},
+	[NMCK_plvatid] = {-1, 1U, {1U}},
+	[NMCK_ptvatid] = {-1, 1U, {1U}},
+	[NMCK_sivatid] = {-1, 1U, {1U}},
+	[NMCK_esvatid] = {-1, 1U, {1U}},
+	[NMCK_gtin] = {-1, 1U, {9U}},
+	[NMCK_credcard] = {-1, 1U, {16U}},
+	[NMCK_isbn] = {-1, 1U, {16U}},
+	[NMCK_isbn10] = {-1, 1U, {16U}},
+	[NMCK_isbn13] = {-1, 1U, {16U}},
+	[NMCK_issn] = {-1, 1U, {16U}},
+	[NMCK_issn8] = {-1, 1U, {16U}},
+	[NMCK_issn13] = {-1, 1U, {16U}},
+	[NMCK_ismn] = {-1, 1U, {16U}},
+	[NMCK_ismn10] = {-1, 1U, {16U}},
+	[NMCK_ismn13] = {-1, 1U, {16U}},
+	[NMCK_cpf] = {-2, 2U, {9U, 1U}},
+	[NMCK_tckimlik] = {-2, 2U, {9U, 1U}},
+	[NMCK_titulo_eleitoral] = {-2, 2U, {9U, 1U}},
+	[NMCK_bevatid] = {-2, 2U, {9U, 1U}},
+	[NMCK_lei] = {-2, 2U, {16U, 8U}},
+	[NMCK_luvatid] = {-2, 2U, {16U, 8U}},
+	[NMCK_iban] = {2, 2U, {16U, 8U}},
+	[NMCK_credref] = {2, 2U, {16U, 8U}},
+	[NMCK_kennitala] = {-2, 1U, {1U}},
+	[NMCK_sevatid] = {-3, 1U, {1U}},
+	[NMCK_nlvatid] = {-4, 1U, {1U}},
+	[NMCK_upn] = {0, 1U, {1U}},
+	[NMCK_ppsn] = {7, 1U, {1U}},
+	[NMCK_vin] = {8, 1U, {1U}},
+	[NMCK_iposan] = {11, 1U, {1U}},
+};
+
+static void
+dec_chk(struct nmck_result *r, const char *str, size_t len)
+{
+/* decode suggested check characters from checker state */
+	const nmck_t s = r->state;
+	size_t off;
+
+	r->nchk = 0U;
+	if (!r->status || s <= 0) {
+		return;
+	}
+	switch (r->type) {
+	case NMCK_imei:
+		if (s == 1) {
+			/* IMEISV, no suggestions */
+			return;
+		}
+		break;
+	case NMCK_tfn:
+		if (len) {
+			r->off[0U] = len - 1U;
+			r->chk[0U] = (char)((s >> 1U & 0xfU) ^ '0');
+			r->nchk = 1U;
+		}
+		return;
+	case NMCK_frvatid:
+		if (len >= 3U) {
+			const unsigned int c = s >> 1U;
+
+			off = (str[0U] == 'F' && str[1U] == 'R') ? 2U : 0U;
+			off += str[off] == ' ';
+			if (off + 2U <= len) {
+				r->off[0U] = off + 0U;
+				r->off[1U] = off + 1U;
+				r->chk[0U] = (char)((c / 10U) ^ '0');
+				r->chk[1U] = (char)((c % 10U) ^ '0');
+				r->nchk = 2U;
+			}
+		}
+		return;
+	case NMCK_isan:
+		off = s >> 8U & 0x7fU;
+		if (off < len) {
+			r->off[0U] = off;
+			r->chk[0U] = (char)(s >> 24U & 0x7fU);
+			r->nchk = 1U;
+			if (off + 1U < len) {
+				r->off[1U] = len - 1U;
+				r->chk[1U] = (char)(s >> 16U & 0x7fU);
+				r->nchk = 2U;
+			}
+		}
+		return;
+	default:
+		break;
+	}
+
+	if (!chkpos[r->type].nchk) {
+		/* no suggestions for this one */
+		return;
+	} else if (chkpos[r->type].off < 0) {
+		if (len < (size_t)-chkpos[r->type].off) {
+			return;
+		}
+		off = len + chkpos[r->type].off;
+	} else if ((off = chkpos[r->type].off) + chkpos[r->type].nchk > len) {
+		return;
+	}
+	for (size_t i = 0U; i < chkpos[r->type].nchk; i++) {
+		r->off[i] = off + i;
+		r->chk[i] = (char)(s >> chkpos[r->type].shft[i] & 0x7fU);
+	}
+	r->nchk = chkpos[r->type].nchk;
+	return;
+}
+
+
+static size_t
+clsf_res(const struct chck_s *ctx,
+	 struct nmck_result *restrict res, const char *str, size_t len)
+{
+	size_t n = 0U;
+
+	for (size_t i = 0U; i < ctx->nsure; i++, n++) {
+		res[n].type = ctx->sure[i].ty;
+		res[n].state = ctx->sure[i].ck;
+		res[n].status = 0U;
+		res[n].sure = 1U;
+		res[n].nchk = 0U;
+	}
+	for (size_t i = 0U; i < ctx->ncand; i++, n++) {
+		res[n].type = ctx->cand[i].ty;
+		res[n].state = ctx->cand[i].ck;
+		res[n].status = (unsigned char)(ctx->cand[i].ck & 0b1U);
+		res[n].sure = 0U;
+		dec_chk(res + n, str, len);
+	}
+	return n;
+}
+
+static inline size_t
+clsf1(struct chck_s *restrict ctx,
+      struct nmck_result *restrict res, const char *str, size_t len)
+{
+	ctx->only = NULL;
+	chck1(ctx, str, len);
+	return clsf_res(ctx, res, str, len);
+}
+
+
+void
+nmck_decode(struct nmck_result *res, const char *str, size_t len)
+{
+	res->status = (unsigned char)(!res->sure && res->state & 0b1U);
+	res->nchk = 0U;
+	if (!res->sure) {
+		dec_chk(res, str, len);
+	}
+	return;
+}
+
+const char*
+nmck_type_name(nmck_type_t t)
+{
+	return t > NMCK_UNK && t < NMCK_NTYPES ? nmck_name[t] : "unknown";
+}
+
+nmck_type_t
+nmck_type_byname(const char *name, size_t len)
+{
+	for (nmck_type_t t = NMCK_UNK + 1U; t < NMCK_NTYPES; t++) {
+		if (!strncmp(nmck_name[t], name, len) && !nmck_name[t][len]) {
+			return t;
+		}
+	}
+	return NMCK_UNK;
+}
+
+size_t
+nmck_classify(const char *str, size_t len, struct nmck_result *res)
+{
+	struct chck_s ctx[1U];
+
+	return clsf1(ctx, res, str, len);
+}
+
+nmck_mach_t
+nmck_mach_byname(const char *name, size_t len)
+{
+	for (nmck_mach_t m = NMCK_MACH_FULL; m < NMCK_NMACHS; m++) {
+		if (!strncmp(mach_name[m], name, len) && !mach_name[m][len]) {
+			return m;
+		}
+	}
+	return NMCK_NMACHS;
+}
+
+size_t
+nmck_classify_mach(
+	nmck_mach_t m, const char *str, size_t len, struct nmck_result *res)
+{
+	struct chck_s ctx[1U];
+
+	if (UNLIKELY(m >= NMCK_NMACHS)) {
+		m = NMCK_MACH_FULL;
+	}
+	ctx->only = NULL;
+	chck[m](ctx, str, len);
+	return clsf_res(ctx, res, str, len);
+}
+
+size_t
+nmck_classify_only(
+	const char *str, size_t len,
+	const nmck_type_t *ty, size_t nty, struct nmck_result *res)
+{
+	struct chck_s ctx[1U];
+	/* 1 for the types in TY, 2 for variants reported as their umbrella */
+	unsigned char only[NMCK_NTYPES] = {0U};
+	size_t n;
+
+	for (size_t i = 0U; i < nty; i++) {
+		if (LIKELY(ty[i] > NMCK_UNK && ty[i] < NMCK_NTYPES)) {
+			only[ty[i]] = 1U;
+		}
+	}
+	for (nmck_type_t t = NMCK_UNK + 1U; t < NMCK_NTYPES; t++) {
+		if (umbrella[t] && !only[t] && only[umbrella[t]]) {
+			only[t] = 2U;
+		}
+	}
+	/* the full dispatcher with everything but TY masked out, so the
+	 * checkers only see inputs of their type's shape */
+	ctx->only = only;
+	chck1(ctx, str, len);
+	n = clsf_res(ctx, res, str, len);
+	for (size_t i = 0U; i < n; i++) {
+		if (only[res[i].type] > 1U) {
+			res[i].type = umbrella[res[i].type];
+		}
+	}
+	return n;
+}
+
+size_t
+nmck_classify_batch(
+	const char *buf, const int32_t *off, size_t n,
+	struct nmck_result *res, size_t nres, int32_t *roff)
+{
+	struct chck_s ctx[1U];
+	size_t r = 0U;
+	size_t i;
+
+	roff[0U] = 0;
+	for (i = 0U; i < n; i++) {
+		const char *str = buf + off[i];
+		const size_t len = off[i + 1U] - off[i];
+		size_t m;
+
+		if (LIKELY(nres - r >= NMCK_NTYPES)) {
+			/* classify straight into the result column */
+			m = clsf1(ctx, res + r, str, len);
+		} else {
+			/* might not fit, go through a scratch column */
+			struct nmck_result tmp[NMCK_NTYPES];
+
+			if ((m = clsf1(ctx, tmp, str, len)) > nres - r) {
+				break;
+			}
+			memcpy(res + r, tmp, m * sizeof(*tmp));
+		}
+		roff[i + 1U] = (int32_t)(r += m);
+	}
+	return i;
+}
+
+const struct nmck_result*
+nmck_completion(
+	const struct nmck_result *res, size_t nres, const char *str, size_t len)
+{
+	size_t nph = 0U;
+
+	for (size_t i = 0U; i < len; i++) {
+		nph += ischeck(str[i]);
+	}
+	for (size_t i = 0U; nph && i < nres; i++) {
+		size_t j;
+
+		if (res[i].nchk != nph) {
+			continue;
+		}
+		for (j = 0U; j < nph && ischeck(str[res[i].off[j]]); j++);
+		if (j == nph) {
+			return res + i;
+		}
+	}
+	return NULL;
+}
+
+int
+nmck_state_init(struct nmck_state *st, nmck_algo_t a)
+{
+	memset(st, 0, sizeof(*st));
+	if (UNLIKELY((unsigned int)a >= NMCK_NALGOS)) {
+		st->err = 1U;
+		return -1;
+	}
+	st->algo = a;
+	return 0;
+}
+
+int
+nmck_state_feed(struct nmck_state *st, char c)
+{
+	if (c == ' ' || c == '-') {
+		/* separators don't count */
+		return 0;
+	} else if (UNLIKELY(st->err)) {
+		return -1;
+	} else if (UNLIKELY(algo[st->algo].feed(st, c) < 0)) {
+		st->err = 1U;
+		return -1;
+	}
+	st->len++;
+	return 0;
+}
+
+int
+nmck_state_final(const struct nmck_state *st)
+{
+	if (UNLIKELY(st->err)) {
+		return -1;
+	}
+	return algo[st->algo].final(st);
+}
+
+nmck_type_t
+nmck_complete(char *str, size_t len, const nmck_type_t *ty, size_t nty)
+{
+	struct nmck_result res[NMCK_NTYPES];
+	const struct nmck_result *r;
+	size_t n;
+
+	if (memchr(str, '_', len) == NULL && memchr(str, '?', len) == NULL) {
+		/* nothing to complete, don't bother classifying */
+		return NMCK_UNK;
+	}
+	n = nty ? nmck_classify_only(str, len, ty, nty, res)
+		: nmck_classify(str, len, res);
+	if ((r = nmck_completion(res, n, str, len)) == NULL) {
+		return NMCK_UNK;
+	}
+	for (size_t j = 0U; j < r->nchk; j++) {
+		str[r->off[j]] = r->chk[j];
+	}
+	return r->type;
+}
+
+/* classify.c ends here */
@@ -40,13 +40,15 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
 	machine numchk;
 
-	cpf = digit{3} "."? digit{3} "."? digit{3} "-"? (digit{2} | check{2}) %{c(cpf)} ;
+	cpf = digit{3} "."? digit{3} "."? digit{3} "-"? (digit{2} | check{2}) %{cd(cpf)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -94,19 +96,53 @@ nmck_cpf(const char *str, size_t len)
 		((char)s1 != str[len - 2U] || (char)s2 != str[len - 1U]);
 }
 
-void
-nmpr_cpf(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_cpf(const struct nmdg_s *dg, const char *str, size_t len)
 {
+/* weights 1 to 9 for the first 9 digits are the payload's bar the
+ * 10th digit, shifting them down by 1 gives the weights for S2 */
+	uint_fast32_t s1, s2;
+
+	if (UNLIKELY(len != 11U)) {
+		return nmck_cpf(str, len);
+	}
+	s1 = dg->w - 10U * dg->d[9U];
+	s2 = s1 - (dg->s[0U] + dg->s[1U] - dg->d[9U]);
+	s1 %= 11U;
+	s1 %= 10U;
+
+	s2 += s1 * 9U;
+	s2 %= 11U;
+	s2 %= 10U;
+	s1 ^= '0';
+	s2 ^= '0';
+
+	return (s1 << 8U ^ s2) << 1U ^
+		((char)s1 != str[len - 2U] || (char)s2 != str[len - 1U]);
+}
+
+size_t
+nmfmt_cpf(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("CPF, conformant", stdout);
+		bp = fmt_lit(bp, "CPF, conformant");
 	} else if (s > 0 && len > 2U) {
-		fputs("CPF, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(s >> 9 & 0x7f, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "CPF, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(s >> 9 & 0x7f);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_cpf(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_cpf, s, str, len);
 	return;
 }
 
@@ -38,7 +38,10 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "luhn.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 typedef enum {
 	ISS_UNK,
@@ -93,42 +96,19 @@ static const char *issuers[] = {
 %%{
 	machine numchk;
 
-	credcard = (digit | " "){12,22} %{c(credcard)} ;
+	credcard = (digit | " "){12,22} %{cd(credcard)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
 
-/* this will always yield a non-0 result in order to track the issuer */
-nmck_t
-nmck_credcard(const char *str, size_t len)
+static nmck_t
+cc_iss(uint_fast32_t x, size_t k, const char *str, size_t len)
 {
-	uint_fast32_t dbl[2U] = {0U, 0U};
-	uint_fast32_t one[2U] = {0U, 0U};
+/* the Luhn sum X of K digits, then the issuer */
 	uint_fast32_t sum;
 	cc_issuer_t iss;
-	size_t k;
 
-	/* common cases first */
-	if (len < 12U || len > 19U + 3U) {
-		return -1;
-	}
-	/* just calc checksum first and sort through issuers later */
-	for (size_t i = k = 0U; i < len - 1U; i++) {
-		uint_fast32_t c = (unsigned char)(str[i] ^ '0');
-
-		if (str[i] == ' ') {
-			continue;
-		} else if (UNLIKELY(c >= 10U)) {
-			return -1;
-		}
-		dbl[k & 0b1U] += 2U * c;
-		one[k & 0b1U] += 2U * c >= 10U;
-		k++;
-	}
-	/* decide now which sum was the 2-weighted one */
-	k++;
-	sum = dbl[(k & 0b1U) ^ 1U] / 2U + dbl[k & 0b1U] + one[k & 0b1U];
-	sum = 100000U - sum;
+	sum = 100000U - x;
 	sum %= 10U;
 	sum ^= '0';
 
@@ -297,29 +277,76 @@ final:
 	return (sum << 8U ^ iss) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_credcard(nmck_t s, const char *str, size_t len)
+/* this will always yield a non-0 result in order to track the issuer */
+nmck_t
+nmck_credcard(const char *str, size_t len)
 {
+	char buf[19U + 3U];
+	const char *dig = str;
+	size_t k = len - 1U;
+	int x;
+
+	/* common cases first */
+	if (len < 12U || len > 19U + 3U) {
+		return -1;
+	} else if (UNLIKELY(memchr(str, ' ', k) != NULL)) {
+		/* squeeze out the blanks */
+		k = 0U;
+		for (size_t i = 0U; i < len - 1U; i++) {
+			buf[k] = str[i];
+			k += str[i] != ' ';
+		}
+		dig = buf;
+	}
+	/* just calc checksum first and sort through issuers later */
+	if (UNLIKELY((x = luhn_sum(dig, k++, 1U)) < 0)) {
+		return -1;
+	}
+	return cc_iss((uint_fast32_t)x, k, str, len);
+}
+
+nmck_t
+nmdg_credcard(const struct nmdg_s *dg, const char *str, size_t len)
+{
+	if (len < 12U || len > 19U + 3U) {
+		return -1;
+	}
+	return cc_iss(dg->l[0U] + dg->s[1U], len, str, len);
+}
+
+size_t
+nmfmt_credcard(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (s < 0) {
 	unk:
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	} else {
 		unsigned int iss = s >> 8U & 0xffU;
 		if (iss < NISSUERS) {
-			fputs(issuers[iss], stdout);
+			bp = fmt_str(bp, issuers[iss]);
 		} else {
-			fprintf(stdout, "issuer %u", iss);
+			bp = fmt_lit(bp, "issuer ");
+			bp = fmt_u(bp, iss);
 		}
 		if (LIKELY(!(s & 0b1U))) {
-			fputs(", conformant account number", stdout);
+			bp = fmt_lit(bp, ", conformant account number");
 		} else if (len > 1U) {
-			fputs(", non-conformant account number, should be ", stdout);
-			fwrite(str, sizeof(*str), len - 1U, stdout);
-			fputc(s >> 16U & 0x7fU, stdout);
+			bp = fmt_lit(bp, ", non-conformant account number, should be ");
+			bp = fmt_mem(bp, str, len - 1U);
+			*bp++ = (char)(s >> 16U & 0x7fU);
 		} else {
 			goto unk;
 		}
 	}
+	return bp - buf;
+}
+
+void
+nmpr_credcard(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_credcard, s, str, len);
 	return;
 }
 
@@ -39,7 +39,9 @@
 #include <stdio.h>
 #include <assert.h>
 #include "numchk.h"
+#include "mod97.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -56,11 +58,9 @@
 nmck_t
 nmck_credref(const char *str, size_t len)
 {
-	uint_fast8_t buf[50U];
-	size_t bsz = 0U;
 	char chk[2U];
-	uint_fast32_t sum = 0U;
-	size_t j = 0U;
+	uint_fast32_t sum;
+	int r;
 
 	/* common cases first */
 	if (len < 6U || len > 33U) {
@@ -69,47 +69,13 @@ nmck_credref(const char *str, size_t len)
 		return -1;
 	}
 
-	/* expand string first */
-	for (size_t i = 4U; i < len; i++) {
-		switch (str[i]) {
-		case ' ':
-			continue;
-		case '0' ... '9':
-			buf[bsz++] = (unsigned char)(str[i] ^ '0');
-			j++;
-			break;
-		case 'A' ... 'J':
-			buf[bsz++] = 1U;
-			buf[bsz++] = (unsigned char)(str[i] - 'A');
-			j++;
-			break;
-		case 'K' ... 'T':
-			buf[bsz++] = 2U;
-			buf[bsz++] = (unsigned char)(str[i] - 'K');
-			j++;
-			break;
-		case 'U' ... 'Z':
-			buf[bsz++] = 3U;
-			buf[bsz++] = (unsigned char)(str[i] - 'U');
-			j++;
-			break;
-		default:
-			return -1;
-		}
+	/* reference first, then RF00 */
+	if (UNLIKELY((r = mod97_fold(0U, str + 4U, len - 4U, ' ', NULL)) < 0)) {
+		return -1;
 	}
-	/* append RF00 */
-	buf[bsz++] = 2,	buf[bsz++] = 7;
-	buf[bsz++] = 1, buf[bsz++] = 5;
-	buf[bsz++] = 0, buf[bsz++] = 0;
+	r = mod97_fold((unsigned int)r, "RF", 2U, -1, NULL);
+	sum = (uint_fast32_t)r * 100U % 97U;
 
-	/* now calc first sum */
-	sum = buf[0U] * 10U + buf[1U];
-	for (size_t i = 2U; i < bsz; sum %= 97U) {
-		for (const size_t n = i + 7U < bsz ? i + 7U : bsz; i < n; i++) {
-			sum *= 10U;
-			sum += buf[i];
-		}
-	}
 	/* this is the actual checksum */
 	sum = 98U - sum;
 	chk[0U] = (char)((sum / 10U) ^ '0');
@@ -120,21 +86,30 @@ nmck_credref(const char *str, size_t len)
 		(chk[0U] != str[2U] || chk[1U] != str[3U]);
 }
 
-void
-nmpr_credref(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_credref(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Creditor Reference, conformant with ISO 11649:2009", stdout);
+		bp = fmt_lit(bp, "Creditor Reference, conformant with ISO 11649:2009");
 	} else if (s > 0 && len >= 4U) {
-		fputs("Creditor Reference, not ISO 11649 conformant, should be ", stdout);
-		fputc('R', stdout);
-		fputc('F', stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
-		fputc(s >> 8U & 0x7fU, stdout);
-		fwrite(str + 4U, sizeof(*str), len - 4U, stdout);
+		bp = fmt_lit(bp, "Creditor Reference, not ISO 11649 conformant, should be ");
+		*bp++ = (char)('R');
+		*bp++ = (char)('F');
+		*bp++ = (char)(s >> 16U & 0x7fU);
+		*bp++ = (char)(s >> 8U & 0x7fU);
+		bp = fmt_mem(bp, str + 4U, len - 4U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_credref(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_credref, s, str, len);
 	return;
 }
 
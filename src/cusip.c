@@ -39,6 +39,7 @@
 #include <stdio.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -96,18 +97,27 @@ nmck_cusip(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_cusip(nmck_t s, const char *str, size_t UNUSED(len))
+size_t
+nmfmt_cusip(char *restrict buf, nmck_t s, const char *str, size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("CUSIP, conformant", stdout);
+		bp = fmt_lit(bp, "CUSIP, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("CUSIP, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "CUSIP, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_cusip(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_cusip, s, str, len);
 	return;
 }
 
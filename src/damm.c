@@ -38,7 +38,10 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "state.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static const uint_fast8_t damm10[10U][10U] = {
 	[0] = {0, 3, 1, 7, 5, 9, 8, 6, 4, 2},
@@ -107,12 +110,40 @@ nmck_damm10(const char *str, size_t len)
 	return !prod - 1;
 }
 
-void
-nmpr_damm10(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+unsigned int
+damm10_prod(const unsigned char *d, size_t n)
+{
+	uint_fast8_t prod = 0U;
+
+	for (size_t i = 0U; i < n; i++) {
+		prod = damm10[prod][d[i]];
+	}
+	return prod;
+}
+
+nmck_t
+nmdg_damm10(const struct nmdg_s *dg,
+	    const char *UNUSED(str), size_t UNUSED(len))
+{
+	return !damm10[dg->dm][dg->d[dg->n - 1U]] - 1;
+}
+
+size_t
+nmfmt_damm10(char *restrict buf, nmck_t s,
+	     const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (!s) {
-		fputs("Damm (dec) secured number, check passed", stdout);
+		bp = fmt_lit(bp, "Damm (dec) secured number, check passed");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_damm10(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_damm10, s, str, len);
 	return;
 }
 
@@ -138,12 +169,57 @@ nmck_damm16(const char *str, size_t len)
 	return !prod - 1;
 }
 
-void
-nmpr_damm16(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+size_t
+nmfmt_damm16(char *restrict buf, nmck_t s,
+	     const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (!s) {
-		fputs("Damm (hex) secured number, check passed", stdout);
+		bp = fmt_lit(bp, "Damm (hex) secured number, check passed");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_damm16(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_damm16, s, str, len);
 	return;
 }
+
+/* incremental, S[0] is the interim digit */
+int
+damm10_feed(struct nmck_state *st, char c)
+{
+	const uint_fast8_t d = (unsigned char)(c ^ '0');
+
+	if (UNLIKELY(d >= 10U)) {
+		return -1;
+	}
+	st->s[0U] = damm10[st->s[0U]][d];
+	return 0;
+}
+
+int
+damm16_feed(struct nmck_state *st, char c)
+{
+	const uint_fast8_t d = _chex(c);
+
+	if (UNLIKELY(d >= 16U)) {
+		return -1;
+	}
+	st->s[0U] = damm16[st->s[0U]][d];
+	return 0;
+}
+
+int
+damm_final(const struct nmck_state *st)
+{
+	if (st->len < 2U) {
+		return -1;
+	}
+	return st->s[0U] != 0U;
+}
+
 /* damm.c ends here */
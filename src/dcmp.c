@@ -0,0 +1,470 @@
+/*** dcmp.c -- transparent decompression of input
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if defined HAVE_CONFIG_H
+# include "config.h"
+#endif	/* HAVE_CONFIG_H */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#if defined HAVE_ZLIB
+# include <zlib.h>
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+# include <zstd.h>
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+# include <lzma.h>
+#endif	/* HAVE_LZMA */
+#include "dcmp.h"
+#include "nifty.h"
+
+/* compressed input is read in pieces of this size */
+#define DCMP_INZ	(64U * 1024U)
+/* decompressed blocks handed from the read-ahead thread, in a ring */
+#define DCMP_BLKZ	(256U * 1024U)
+#define DCMP_NBLK	4U
+
+typedef enum {
+	DCMP_RAW,
+	DCMP_GZIP,
+	DCMP_ZSTD,
+	DCMP_XZ,
+} dcmp_codec_t;
+
+struct dcmp_s {
+	int fd;
+	dcmp_codec_t codec;
+	/* read-ahead of FD, IIN bytes of which have been consumed */
+	char *in;
+	size_t nin;
+	size_t iin;
+	/* FD at end of file, we're past the last stream, or broken */
+	unsigned int eof:1;
+	unsigned int end:1;
+	unsigned int err:1;
+	/* in the middle of a stream, i.e. more input is expected */
+	unsigned int mid:1;
+	union {
+#if defined HAVE_ZLIB
+		z_stream z;
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+		ZSTD_DStream *zs;
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+		lzma_stream x;
+#endif	/* HAVE_LZMA */
+		char nil;
+	};
+
+	/* read-ahead thread and its ring of blocks, blocks are produced
+	 * at HEAD and consumed at TAIL, of which OFF bytes are gone */
+	pthread_t thr;
+	unsigned int thrp:1;
+	unsigned int quit:1;
+	pthread_mutex_t mtx;
+	pthread_cond_t cnd;
+	char *blk;
+	ssize_t nblk[DCMP_NBLK];
+	size_t head;
+	size_t tail;
+	size_t off;
+};
+
+static const char *const codecs[] = {
+	[DCMP_GZIP] = "gzip",
+	[DCMP_ZSTD] = "zstd",
+	[DCMP_XZ] = "xz",
+};
+
+
+static dcmp_codec_t
+magic(const char *UNUSED(s), size_t UNUSED(n))
+{
+	if (0) {
+		;
+#if defined HAVE_ZLIB
+	} else if (n >= 2U && !memcmp(s, "\x1f\x8b", 2U)) {
+		return DCMP_GZIP;
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+	} else if (n >= 4U && !memcmp(s, "\x28\xb5\x2f\xfd", 4U)) {
+		return DCMP_ZSTD;
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+	} else if (n >= 6U && !memcmp(s, "\xfd" "7zXZ\0", 6U)) {
+		return DCMP_XZ;
+#endif	/* HAVE_LZMA */
+	}
+	return DCMP_RAW;
+}
+
+static int
+init(struct dcmp_s *d)
+{
+	switch (d->codec) {
+#if defined HAVE_ZLIB
+	case DCMP_GZIP:
+		/* 32 on top of the window bits detects the gzip header */
+		return -(inflateInit2(&d->z, 15 + 32) != Z_OK);
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+	case DCMP_ZSTD:
+		if ((d->zs = ZSTD_createDStream()) == NULL) {
+			return -1;
+		}
+		return -ZSTD_isError(ZSTD_initDStream(d->zs));
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+	case DCMP_XZ:
+		d->x = (lzma_stream)LZMA_STREAM_INIT;
+		return -(lzma_stream_decoder(
+				 &d->x, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK);
+#endif	/* HAVE_LZMA */
+	default:
+		break;
+	}
+	return 0;
+}
+
+static void
+fini(struct dcmp_s *d)
+{
+	switch (d->codec) {
+#if defined HAVE_ZLIB
+	case DCMP_GZIP:
+		inflateEnd(&d->z);
+		break;
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+	case DCMP_ZSTD:
+		ZSTD_freeDStream(d->zs);
+		break;
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+	case DCMP_XZ:
+		lzma_end(&d->x);
+		break;
+#endif	/* HAVE_LZMA */
+	default:
+		break;
+	}
+	return;
+}
+
+static int
+step(struct dcmp_s *d,
+     char *UNUSED(buf), size_t UNUSED(bsz), size_t *UNUSED(n))
+{
+/* decompress what's there into BUF, of which *N bytes are in use */
+	switch (d->codec) {
+#if defined HAVE_ZLIB
+	case DCMP_GZIP:
+		d->z.next_in = (unsigned char*)d->in + d->iin;
+		d->z.avail_in = d->nin - d->iin;
+		d->z.next_out = (unsigned char*)buf + *n;
+		d->z.avail_out = bsz - *n;
+		switch (inflate(&d->z, Z_NO_FLUSH)) {
+		case Z_STREAM_END:
+			/* gzip members may simply be concatenated */
+			d->mid = 0U;
+			inflateReset(&d->z);
+			break;
+		case Z_OK:
+			d->mid = 1U;
+			break;
+		case Z_BUF_ERROR:
+			/* no progress, we'll find out why below */
+			break;
+		default:
+			return -1;
+		}
+		d->iin = d->nin - d->z.avail_in;
+		*n = bsz - d->z.avail_out;
+		break;
+#endif	/* HAVE_ZLIB */
+#if defined HAVE_ZSTD
+	case DCMP_ZSTD:
+		with (ZSTD_inBuffer ib = {d->in, d->nin, d->iin}) {
+			ZSTD_outBuffer ob = {buf, bsz, *n};
+			size_t r = ZSTD_decompressStream(d->zs, &ob, &ib);
+
+			if (ZSTD_isError(r)) {
+				return -1;
+			}
+			/* 0 means at the end of a frame, past which R
+			 * hints at the next frame even if there's none */
+			if (ib.pos > d->iin || ob.pos > *n) {
+				d->mid = r > 0U;
+			}
+			d->iin = ib.pos;
+			*n = ob.pos;
+		}
+		break;
+#endif	/* HAVE_ZSTD */
+#if defined HAVE_LZMA
+	case DCMP_XZ:
+		d->x.next_in = (uint8_t*)d->in + d->iin;
+		d->x.avail_in = d->nin - d->iin;
+		d->x.next_out = (uint8_t*)buf + *n;
+		d->x.avail_out = bsz - *n;
+		/* concatenated streams only end when told so */
+		switch (lzma_code(&d->x, d->eof ? LZMA_FINISH : LZMA_RUN)) {
+		case LZMA_STREAM_END:
+			d->mid = 0U;
+			d->end = 1U;
+			break;
+		case LZMA_OK:
+		case LZMA_BUF_ERROR:
+			d->mid = 1U;
+			break;
+		default:
+			return -1;
+		}
+		d->iin = d->nin - d->x.avail_in;
+		*n = bsz - d->x.avail_out;
+		break;
+#endif	/* HAVE_LZMA */
+	default:
+		return -1;
+	}
+	return 0;
+}
+
+static ssize_t
+fill(struct dcmp_s *d, char *buf, size_t bsz)
+{
+/* decompress straight into BUF until it's full or the input is over */
+	size_t n = 0U;
+
+	while (n < bsz && !d->end && !d->err) {
+		const size_t n0 = n;
+
+		if (d->iin >= d->nin && !d->eof) {
+			ssize_t nrd = read(d->fd, d->in, DCMP_INZ);
+
+			if (UNLIKELY(nrd < 0)) {
+				d->err = 1U;
+				break;
+			}
+			d->eof = !nrd;
+			d->nin = nrd;
+			d->iin = 0U;
+		}
+		if (UNLIKELY(step(d, buf, bsz, &n) < 0)) {
+			d->err = 1U;
+		} else if (d->iin >= d->nin && d->eof && n == n0) {
+			/* no input, no output, and a truncated stream
+			 * is as good as a broken one */
+			d->end = 1U;
+			d->err = d->mid;
+		}
+	}
+	return n ? (ssize_t)n : d->err ? -1 : 0;
+}
+
+static void*
+rdah(void *arg)
+{
+/* the read-ahead thread */
+	struct dcmp_s *d = arg;
+	ssize_t nrd;
+
+	do {
+		unsigned int quit;
+
+		pthread_mutex_lock(&d->mtx);
+		while (d->head - d->tail >= DCMP_NBLK && !d->quit) {
+			pthread_cond_wait(&d->cnd, &d->mtx);
+		}
+		quit = d->quit;
+		pthread_mutex_unlock(&d->mtx);
+		if (quit) {
+			break;
+		}
+
+		with (size_t i = d->head % DCMP_NBLK) {
+			nrd = fill(d, d->blk + i * DCMP_BLKZ, DCMP_BLKZ);
+			d->nblk[i] = nrd;
+		}
+
+		pthread_mutex_lock(&d->mtx);
+		d->head++;
+		pthread_cond_signal(&d->cnd);
+		pthread_mutex_unlock(&d->mtx);
+	} while (nrd > 0);
+	return NULL;
+}
+
+
+struct dcmp_s*
+dcmp_open(int fd)
+{
+	struct dcmp_s *d;
+	struct stat st;
+	off_t off;
+
+	if (UNLIKELY((d = calloc(1U, sizeof(*d))) == NULL)) {
+		return NULL;
+	} else if (UNLIKELY((d->in = malloc(DCMP_INZ)) == NULL)) {
+		goto nul;
+	}
+	d->fd = fd;
+
+	/* have a look at the magic bytes, regular files are peeked at so
+	 * that plain input can still be mapped by the caller */
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode) &&
+	    (off = lseek(fd, 0, SEEK_CUR)) >= 0) {
+		char pk[8U];
+		ssize_t npk = pread(fd, pk, sizeof(pk), off);
+
+		d->codec = magic(pk, npk > 0 ? npk : 0U);
+	} else {
+		ssize_t nrd;
+
+		while (d->nin < 6U &&
+		       (nrd = read(fd, d->in + d->nin, DCMP_INZ - d->nin)) > 0) {
+			d->nin += nrd;
+		}
+		d->codec = magic(d->in, d->nin);
+	}
+	if (d->codec == DCMP_RAW) {
+		return d;
+	} else if (UNLIKELY(init(d) < 0)) {
+		goto fin;
+	}
+
+	/* decompress ahead while the caller is busy, or else in place */
+	if (UNLIKELY((d->blk = malloc(DCMP_NBLK * DCMP_BLKZ)) == NULL)) {
+		return d;
+	}
+	pthread_mutex_init(&d->mtx, NULL);
+	pthread_cond_init(&d->cnd, NULL);
+	if (UNLIKELY(pthread_create(&d->thr, NULL, rdah, d))) {
+		pthread_cond_destroy(&d->cnd);
+		pthread_mutex_destroy(&d->mtx);
+		free(d->blk);
+		d->blk = NULL;
+		return d;
+	}
+	d->thrp = 1U;
+	return d;
+
+fin:
+	fini(d);
+	free(d->in);
+nul:
+	free(d);
+	return NULL;
+}
+
+void
+dcmp_close(struct dcmp_s *d)
+{
+	if (d == NULL) {
+		return;
+	}
+	if (d->thrp) {
+		pthread_mutex_lock(&d->mtx);
+		d->quit = 1U;
+		pthread_cond_signal(&d->cnd);
+		pthread_mutex_unlock(&d->mtx);
+		pthread_join(d->thr, NULL);
+		pthread_cond_destroy(&d->cnd);
+		pthread_mutex_destroy(&d->mtx);
+	}
+	fini(d);
+	free(d->blk);
+	free(d->in);
+	free(d);
+	return;
+}
+
+const char*
+dcmp_codec(const struct dcmp_s *d)
+{
+	return codecs[d->codec];
+}
+
+ssize_t
+dcmp_read(struct dcmp_s *d, char *buf, size_t bsz)
+{
+	size_t i, n;
+	ssize_t nb;
+
+	if (d->codec == DCMP_RAW) {
+		/* peeked bytes first */
+		if (d->iin < d->nin) {
+			n = d->nin - d->iin;
+			n = n < bsz ? n : bsz;
+			memcpy(buf, d->in + d->iin, n);
+			d->iin += n;
+			return n;
+		}
+		return read(d->fd, buf, bsz);
+	} else if (!d->thrp) {
+		return fill(d, buf, bsz);
+	}
+
+	pthread_mutex_lock(&d->mtx);
+	while (d->head == d->tail) {
+		pthread_cond_wait(&d->cnd, &d->mtx);
+	}
+	pthread_mutex_unlock(&d->mtx);
+
+	i = d->tail % DCMP_NBLK;
+	if ((nb = d->nblk[i]) <= 0) {
+		/* end of input or error, for good */
+		return nb;
+	}
+	n = nb - d->off;
+	n = n < bsz ? n : bsz;
+	memcpy(buf, d->blk + i * DCMP_BLKZ + d->off, n);
+	if ((d->off += n) >= (size_t)nb) {
+		d->off = 0U;
+		pthread_mutex_lock(&d->mtx);
+		d->tail++;
+		pthread_cond_signal(&d->cnd);
+		pthread_mutex_unlock(&d->mtx);
+	}
+	return n;
+}
+
+/* dcmp.c ends here */
@@ -0,0 +1,68 @@
+/*** dcmp.h -- transparent decompression of input
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_dcmp_h_
+#define INCLUDED_dcmp_h_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/**
+ * Reader on a file descriptor that inflates gzip, zstd or xz input on
+ * the fly, depending on the codecs found at configure time, and passes
+ * anything else through unchanged.
+ * Where possible the input is decompressed ahead by a thread of its own
+ * while the caller gets on with the previous block. */
+struct dcmp_s;
+
+/**
+ * Open a reader on FD, the codec is determined by FD's magic bytes.
+ * Return NULL if memory is short. */
+extern struct dcmp_s *dcmp_open(int fd);
+
+/**
+ * Return the name of the codec in use, or NULL if the input is passed
+ * through, in which case FD has not been read from if it's a regular
+ * file. */
+extern const char *dcmp_codec(const struct dcmp_s*);
+
+/**
+ * Like read(2), fill BUF with up to BSZ bytes of decompressed input. */
+extern ssize_t dcmp_read(struct dcmp_s*, char *buf, size_t bsz);
+
+extern void dcmp_close(struct dcmp_s*);
+
+#endif	/* INCLUDED_dcmp_h_ */
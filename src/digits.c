@@ -0,0 +1,193 @@
+/*** digits.c -- fused pass over all-digit input
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <string.h>
+#include "digits.h"
+#include "nifty.h"
+
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+# define DIGITS_X86
+# include <immintrin.h>
+#endif	/* __x86_64__ || __i386__ */
+
+/* the Luhn value of a doubled digit */
+static const unsigned char luhn_dbl[16U] = {
+	0U, 2U, 4U, 6U, 8U, 1U, 3U, 5U, 7U, 9U,
+};
+
+
+static int
+scan_gen(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+	unsigned int s[2U] = {0U, 0U};
+	unsigned int l[2U] = {0U, 0U};
+	unsigned int w = 0U;
+	size_t i;
+
+	/* the last payload digit is at even distance */
+	for (i = 0U; i < len - 1U; i++) {
+		const unsigned int c = (unsigned char)(str[i] ^ '0');
+		const unsigned int k = (len ^ i) & 0b1U;
+
+		if (UNLIKELY(c >= 10U)) {
+			return -1;
+		}
+		dg->d[i] = (unsigned char)c;
+		s[k] += c;
+		l[k] += luhn_dbl[c];
+		w += (i + 1U) * c;
+	}
+	if (UNLIKELY((dg->d[i] = (unsigned char)(str[i] ^ '0')) >= 10U)) {
+		return -1;
+	}
+	dg->s[0U] = s[0U], dg->s[1U] = s[1U];
+	dg->l[0U] = l[0U], dg->l[1U] = l[1U];
+	dg->w = w;
+	return 0;
+}
+
+#if defined DIGITS_X86
+/* Up to two blocks of 16 digits, left-aligned so that lane I carries
+ * the weight I + 1, lanes past the payload are zeroed before summing.
+ * Blocks start at even lanes so the lanes at even distance to the last
+ * payload digit are the ones with the parity of LEN in either block. */
+static __attribute__((target("sse4.1"))) int
+scan_sse(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i tbl = _mm_loadu_si128((const void*)luhn_dbl);
+	const __m128i idx = _mm_setr_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i par = _mm_set1_epi16(len & 0b1U ? (short)0xff00 : 0x00ff);
+	__m128i s = _mm_setzero_si128();
+	__m128i s0 = _mm_setzero_si128();
+	__m128i l = _mm_setzero_si128();
+	__m128i l0 = _mm_setzero_si128();
+	__m128i w = _mm_setzero_si128();
+	char pad[NMDG_MAXLEN];
+
+	memset(pad, '0', sizeof(pad));
+	memcpy(pad, str, len);
+	for (size_t i = 0U; i < len; i += 16U) {
+		__m128i d = _mm_loadu_si128((const void*)(pad + i));
+		__m128i x;
+
+		d = _mm_sub_epi8(d, _mm_set1_epi8('0'));
+		if (UNLIKELY(_mm_movemask_epi8(
+				     _mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine)) != 0xffff)) {
+			return -1;
+		}
+		_mm_storeu_si128((void*)(dg->d + i), d);
+		/* payload lanes only */
+		d = _mm_and_si128(d, _mm_cmpgt_epi8(
+					  _mm_set1_epi8((char)(len - 1U - i)), idx));
+		s = _mm_add_epi64(s, _mm_sad_epu8(d, _mm_setzero_si128()));
+		s0 = _mm_add_epi64(s0, _mm_sad_epu8(
+					   _mm_and_si128(d, par), _mm_setzero_si128()));
+		x = _mm_shuffle_epi8(tbl, d);
+		l = _mm_add_epi64(l, _mm_sad_epu8(x, _mm_setzero_si128()));
+		l0 = _mm_add_epi64(l0, _mm_sad_epu8(
+					   _mm_and_si128(x, par), _mm_setzero_si128()));
+		x = _mm_maddubs_epi16(
+			d, _mm_add_epi8(idx, _mm_set1_epi8((char)(i + 1U))));
+		w = _mm_add_epi32(w, _mm_madd_epi16(x, _mm_set1_epi16(1)));
+	}
+	s = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+	s0 = _mm_add_epi64(s0, _mm_unpackhi_epi64(s0, s0));
+	l = _mm_add_epi64(l, _mm_unpackhi_epi64(l, l));
+	l0 = _mm_add_epi64(l0, _mm_unpackhi_epi64(l0, l0));
+	w = _mm_hadd_epi32(w, w);
+	w = _mm_hadd_epi32(w, w);
+	dg->s[0U] = (unsigned int)_mm_cvtsi128_si32(s0);
+	dg->s[1U] = (unsigned int)_mm_cvtsi128_si32(s) - dg->s[0U];
+	dg->l[0U] = (unsigned int)_mm_cvtsi128_si32(l0);
+	dg->l[1U] = (unsigned int)_mm_cvtsi128_si32(l) - dg->l[0U];
+	dg->w = (unsigned int)_mm_cvtsi128_si32(w);
+	return 0;
+}
+
+static int scan_rslv(struct nmdg_s *restrict, const char*, size_t);
+static int(*scan_f)(struct nmdg_s *restrict, const char*, size_t) = scan_rslv;
+
+static int
+scan_rslv(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+/* pick the best kernel for this cpu, racing threads will agree */
+	int(*f)(struct nmdg_s *restrict, const char*, size_t) = scan_gen;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.1")) {
+		f = scan_sse;
+	}
+	__atomic_store_n(&scan_f, f, __ATOMIC_RELAXED);
+	return f(dg, str, len);
+}
+
+static inline int
+scan(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+	return __atomic_load_n(&scan_f, __ATOMIC_RELAXED)(dg, str, len);
+}
+
+#else  /* !DIGITS_X86 */
+static inline int
+scan(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+	return scan_gen(dg, str, len);
+}
+#endif	/* DIGITS_X86 */
+
+
+void
+nmdg_scan(struct nmdg_s *restrict dg, const char *str, size_t len)
+{
+	dg->n = 0U;
+	if (len < 2U || len > NMDG_MAXLEN) {
+		return;
+	} else if ((unsigned char)(*str ^ '0') >= 10U) {
+		/* most other identifiers start with a letter */
+		return;
+	} else if (scan(dg, str, len) < 0) {
+		return;
+	}
+	/* the chains are table walks, but over digits at hand */
+	dg->vp = (unsigned char)verhoeff_prod(dg->d, len - 1U);
+	dg->dm = (unsigned char)damm10_prod(dg->d, len - 1U);
+	dg->n = len;
+	return;
+}
+
+/* digits.c ends here */
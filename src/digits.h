@@ -0,0 +1,90 @@
+/*** digits.h -- fused pass over all-digit input
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_digits_h_
+#define INCLUDED_digits_h_
+
+#include <stddef.h>
+#include "numchk.h"
+
+/* longest all-digit input to digest, the digit checkers stay below */
+#define NMDG_MAXLEN	32U
+
+/* Digest of an all-digit string of length N, the payload being all
+ * digits but the last.  Payload sums are split by the parity of the
+ * distance to the last payload digit, S[0] holds the digits at even
+ * distance, i.e. including the last one, S[1] the others. */
+struct nmdg_s {
+	/* number of digits, 0 if the input wasn't digested */
+	size_t n;
+	/* the digits as numbers */
+	unsigned char d[NMDG_MAXLEN];
+	/* payload sums, plain and Luhn-doubled */
+	unsigned int s[2U];
+	unsigned int l[2U];
+	/* payload sum weighted by position, 1 for the first digit */
+	unsigned int w;
+	/* Verhoeff product of the payload, its first permutation being
+	 * the one for distance 1, and the Damm interim of the payload */
+	unsigned char vp;
+	unsigned char dm;
+};
+
+/**
+ * Digest STR of length LEN in one pass, DG->n is 0 unless STR consists
+ * of 2 to NMDG_MAXLEN digits. */
+extern void nmdg_scan(struct nmdg_s *restrict dg, const char *str, size_t len);
+
+/* the chains, over N digits D */
+extern unsigned int verhoeff_prod(const unsigned char *d, size_t n);
+extern unsigned int damm10_prod(const unsigned char *d, size_t n);
+
+/* Checkers on digested input, they return what their nmck_*()
+ * counterparts return on STR. */
+extern nmck_t nmdg_luhn(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_verhoeff(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_damm10(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_gtin(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_isbn10(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_credcard(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_imei(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_tckimlik(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_aadhaar(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_cpf(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_npi(const struct nmdg_s *dg, const char *str, size_t len);
+extern nmck_t nmdg_nhs(const struct nmdg_s *dg, const char *str, size_t len);
+
+#endif	/* INCLUDED_digits_h_ */
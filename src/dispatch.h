@@ -0,0 +1,125 @@
+/*** dispatch.h -- shared bits of the dispatcher machines
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_dispatch_h_
+#define INCLUDED_dispatch_h_
+
+#include "numchk.h"
+#include "digits.h"
+#include "nifty.h"
+
+#define NNMCK	(NMCK_NTYPES)
+
+#define maybe(x, y)	\
+	ctx->cand[ctx->ncand++] = (struct nmres_s){NMCK_##x, y}
+#define defo(x, y)	\
+	ctx->sure[ctx->nsure++] = (struct nmres_s){NMCK_##x, y}
+/* whether checker X is to be run, cf. nmck_classify_only() */
+#define want(x)	\
+	(ctx->only == NULL || ctx->only[NMCK_##x])
+
+#define c(x)	\
+	if (want(x)) with (nmck_t y = nmck_##x(str, len)) { \
+		if (y < 0) { \
+			break; \
+		} else if (y & 0b1U) { \
+			maybe(x, y); \
+		} else { \
+			defo(x, y); \
+		} \
+	}
+#define g(x)	\
+	if (want(x)) with (nmck_t y = nmck_##x(str, len)) { \
+		if (y < 0) { \
+			break; \
+		} else { \
+			maybe(x, y); \
+		} \
+	}
+/* like c() and g(), handing over the digest DG of all-digit input */
+#define cd(x)	\
+	if (want(x)) with (nmck_t y = dg->n \
+	      ? nmdg_##x(dg, str, len) : nmck_##x(str, len)) { \
+		if (y < 0) { \
+			break; \
+		} else if (y & 0b1U) { \
+			maybe(x, y); \
+		} else { \
+			defo(x, y); \
+		} \
+	}
+#define gd(x)	\
+	if (want(x)) with (nmck_t y = dg->n \
+	      ? nmdg_##x(dg, str, len) : nmck_##x(str, len)) { \
+		if (y < 0) { \
+			break; \
+		} else { \
+			maybe(x, y); \
+		} \
+	}
+
+#ifdef __INTEL_COMPILER
+# pragma warning (disable:2415)
+#endif  /* __INTEL_COMPILER */
+
+/* result set of one chck1() call */
+struct nmres_s {
+	nmck_type_t ty;
+	nmck_t ck;
+};
+
+struct chck_s {
+	/* checkers to run by type, all of them if NULL */
+	const unsigned char *only;
+	size_t ncand;
+	size_t nsure;
+	struct nmres_s cand[NNMCK];
+	struct nmres_s sure[NNMCK];
+};
+
+#ifdef RAGEL_BLOCK
+%%{
+	machine numchk;
+
+	upnum = digit | upper;
+	lonum = digit | lower;
+	check = "_" | "?";
+	vowel = "A" | "E" | "I" | "O" | "U";
+	consonant = upper - vowel;
+}%%
+#endif	/* RAGEL_BLOCK */
+
+#endif	/* INCLUDED_dispatch_h_ */
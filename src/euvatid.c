@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static inline int
 isdigit(int x)
@@ -108,7 +109,9 @@ nmck_devatid(const char *str, size_t len)
 	}
 	sum = (11U - sum) % 10U;
 	sum ^= '0';
-	stc = str[i++];
+	/* the check digit might be missing altogether */
+	stc = i < len ? (unsigned char)str[i] : '\0';
+	i++;
 
 	if (i < len) {
 		/* more? */
@@ -118,18 +121,27 @@ nmck_devatid(const char *str, size_t len)
 	return sum << 1U ^ (stc != sum);
 }
 
-void
-nmpr_devatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_devatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("German VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "German VAT-ID, conformant");
 	} else if (s > 0 && len > 0) {
-		fputs("German VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "German VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_devatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_devatid, s, str, len);
 	return;
 }
 
@@ -167,20 +179,29 @@ nmck_bevatid(const char *str, size_t len)
 		(chk[0U] != str[len - 2U] || chk[1U] != str[len - 1U]);
 }
 
-void
-nmpr_bevatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_bevatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Belgian VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Belgian VAT-ID, conformant");
 	} else if (s > 0 && len >= 2U) {
 		uint_fast32_t c = s >> 1U;
-		fputs("Belgian VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(c >> 8U & 0x7fU, stdout);
-		fputc(c >> 0U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Belgian VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(c >> 8U & 0x7fU);
+		*bp++ = (char)(c >> 0U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_bevatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_bevatid, s, str, len);
 	return;
 }
 
@@ -224,18 +245,27 @@ nmck_dkvatid(const char *str, size_t len)
 	return sum << 1U ^ (sum > 0);
 }
 
-void
-nmpr_dkvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_dkvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Danish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Danish VAT-ID, conformant");
 	} else if (s > 0 && len >= 2U) {
-		fputs("Danish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Danish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_dkvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_dkvatid, s, str, len);
 	return;
 }
 
@@ -274,18 +304,27 @@ nmck_fivatid(const char *str, size_t len)
 	return sum << 1U ^ (sum > 0);
 }
 
-void
-nmpr_fivatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_fivatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Finnish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Finnish VAT-ID, conformant");
 	} else if (s > 0 && len >= 2U) {
-		fputs("Finnish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Finnish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_fivatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_fivatid, s, str, len);
 	return;
 }
 
@@ -336,11 +375,13 @@ nmck_frvatid(const char *str, size_t len)
 	return sum << 1U ^ (sum != ccs);
 }
 
-void
-nmpr_frvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_frvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("French VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "French VAT-ID, conformant");
 	} else if (s > 0 && len >= 3U) {
 		uint_fast32_t c = s >> 1U;
 		size_t plen = 0U;
@@ -349,14 +390,21 @@ nmpr_frvatid(nmck_t s, const char *str, size_t len)
 		plen += (str[0U] == 'F') && str[1U] == 'R';
 		plen += str[plen] == ' ';
 
-		fputs("French VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), plen, stdout);
-		fputc((c / 10U) ^ '0', stdout);
-		fputc((c % 10U) ^ '0', stdout);
-		fwrite(str + plen + 2U, sizeof(*str), len - (plen + 2U), stdout);
+		bp = fmt_lit(bp, "French VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, plen);
+		*bp++ = (char)((c / 10U) ^ '0');
+		*bp++ = (char)((c % 10U) ^ '0');
+		bp = fmt_mem(bp, str + plen + 2U, len - (plen + 2U));
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_frvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_frvatid, s, str, len);
 	return;
 }
 
@@ -388,18 +436,27 @@ nmck_grvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_grvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_grvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Greek VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Greek VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Greek VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Greek VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_grvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_grvatid, s, str, len);
 	return;
 }
 
@@ -451,18 +508,27 @@ nmck_ievatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_ievatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ievatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Irish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Irish VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Irish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Irish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ievatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ievatid, s, str, len);
 	return;
 }
 
@@ -499,18 +565,27 @@ nmck_itvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_itvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_itvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Italian VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Italian VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Italian VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Italian VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_itvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_itvatid, s, str, len);
 	return;
 }
 
@@ -551,19 +626,28 @@ nmck_luvatid(const char *str, size_t len)
 		((char)chk[0U] != str[len - 2U] || (char)chk[1U] != str[len - 1U]);
 }
 
-void
-nmpr_luvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_luvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Luxembourgian VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Luxembourgian VAT-ID, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("Luxembourgian VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
-		fputc(s >> 8U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Luxembourgian VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(s >> 16U & 0x7fU);
+		*bp++ = (char)(s >> 8U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_luvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_luvatid, s, str, len);
 	return;
 }
 
@@ -601,19 +685,28 @@ nmck_nlvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 4U]);
 }
 
-void
-nmpr_nlvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_nlvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Dutch VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Dutch VAT-ID, conformant");
 	} else if (s > 0 && len > 3U) {
-		fputs("Dutch VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 4U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
-		fwrite(str + len - 3U, sizeof(*str), 3U, stdout);
+		bp = fmt_lit(bp, "Dutch VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 4U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
+		bp = fmt_mem(bp, str + len - 3U, 3U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_nlvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_nlvatid, s, str, len);
 	return;
 }
 
@@ -651,18 +744,27 @@ nmck_atvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_atvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_atvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Austrian VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Austrian VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Austrian VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Austrian VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_atvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_atvatid, s, str, len);
 	return;
 }
 
@@ -699,18 +801,27 @@ nmck_plvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_plvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_plvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Polish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Polish VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Polish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Polish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_plvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_plvatid, s, str, len);
 	return;
 }
 
@@ -747,18 +858,27 @@ nmck_ptvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_ptvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ptvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Portuguese VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Portuguese VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Portuguese VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Portuguese VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ptvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ptvatid, s, str, len);
 	return;
 }
 
@@ -794,20 +914,29 @@ nmck_sevatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 3U]);
 }
 
-void
-nmpr_sevatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_sevatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Swedish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Swedish VAT-ID, conformant");
 	} else if (s > 0 && len >= 3U) {
-		fputs("Swedish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 3U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
-		fputc(str[len - 2U], stdout);
-		fputc(str[len - 1U], stdout);
+		bp = fmt_lit(bp, "Swedish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 3U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
+		*bp++ = (char)(str[len - 2U]);
+		*bp++ = (char)(str[len - 1U]);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_sevatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_sevatid, s, str, len);
 	return;
 }
 
@@ -854,18 +983,27 @@ nmck_sivatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_sivatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_sivatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Slovenian VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Slovenian VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Slovenian VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Slovenian VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_sivatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_sivatid, s, str, len);
 	return;
 }
 
@@ -907,18 +1045,27 @@ nmck_esvatid(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_esvatid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_esvatid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("Spanish VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "Spanish VAT-ID, conformant");
 	} else if (s > 0 && len > 0U) {
-		fputs("Spanish VAT-ID, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "Spanish VAT-ID, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_esvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_esvatid, s, str, len);
 	return;
 }
 
@@ -973,16 +1120,26 @@ nmck_ukvatid(const char *str, size_t len)
 	return !(sum == 0U || str[i1] != '0' && sum == 42U);
 }
 
-void
-nmpr_ukvatid(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+size_t
+nmfmt_ukvatid(char *restrict buf, nmck_t s,
+	      const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("UK VAT-ID, conformant", stdout);
+		bp = fmt_lit(bp, "UK VAT-ID, conformant");
 	} else if (s > 0) {
-		fputs("UK VAT-ID, not conformant", stdout);
+		bp = fmt_lit(bp, "UK VAT-ID, not conformant");
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ukvatid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ukvatid, s, str, len);
 	return;
 }
 
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -108,18 +109,27 @@ nmck_figi(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_figi(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_figi(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("FIGI, conformant with http://www.omg.org/spec/FIGI/1.0", stdout);
+		bp = fmt_lit(bp, "FIGI, conformant with http://www.omg.org/spec/FIGI/1.0");
 	} else if (s > 0 && len == 12U) {
-		fputs("FIGI, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 11U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "FIGI, not conformant, should be ");
+		bp = fmt_mem(bp, str, 11U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_figi(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_figi, s, str, len);
 	return;
 }
 
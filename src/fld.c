@@ -0,0 +1,154 @@
+/*** fld.c -- delimited field scanner
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdint.h>
+#include <string.h>
+#include "fld.h"
+#include "nifty.h"
+
+#if defined __SSE2__
+# include <emmintrin.h>
+#endif	/* __SSE2__ */
+
+/* lines are scanned in blocks of this many bytes */
+#define BLKZ	32U
+
+
+static inline uint32_t
+blk_msk(const char *p, char c)
+{
+/* bit I is set iff P[I] == C */
+#if defined __SSE2__
+	const __m128i x = _mm_set1_epi8(c);
+	const __m128i lo = _mm_loadu_si128((const void*)p);
+	const __m128i hi = _mm_loadu_si128((const void*)(p + 16U));
+	const uint32_t ml = _mm_movemask_epi8(_mm_cmpeq_epi8(lo, x));
+	const uint32_t mh = _mm_movemask_epi8(_mm_cmpeq_epi8(hi, x));
+
+	return ml | mh << 16U;
+#else  /* !__SSE2__ */
+	uint32_t m = 0U;
+
+	for (unsigned int i = 0U; i < BLKZ; i++) {
+		m |= (uint32_t)(p[i] == c) << i;
+	}
+	return m;
+#endif	/* __SSE2__ */
+}
+
+
+int
+fld_find(struct fld_s *restrict f,
+	 const char *str, size_t len, char dlm, size_t fn)
+{
+	/* number of unquoted delimiters seen so far */
+	size_t nd = 0U;
+	size_t beg = 0U;
+	unsigned int inq = 0U;
+
+	for (size_t i = 0U; i < len; i += BLKZ) {
+		const char *p = str + i;
+		uint32_t lim = (uint32_t)-1;
+		char pad[BLKZ];
+		uint32_t dm, qm;
+
+		if (UNLIKELY(len - i < BLKZ)) {
+			/* never look past STR */
+			memcpy(pad, p, len - i);
+			memset(pad + (len - i), 0, BLKZ - (len - i));
+			lim = ((uint32_t)1U << (len - i)) - 1U;
+			p = pad;
+		}
+		dm = blk_msk(p, dlm) & lim;
+		qm = blk_msk(p, '"') & lim;
+		if (LIKELY(!inq && !qm)) {
+			/* no quoting, skip the block if neither
+			 * the start nor the end of our field is in it */
+			const size_t pc = __builtin_popcount(dm);
+
+			if (!pc || nd + pc < fn) {
+				nd += pc;
+				continue;
+			}
+		}
+		for (uint32_t m = dm | qm; m; m &= m - 1U) {
+			const size_t j = i + __builtin_ctz(m);
+
+			if (str[j] == '"') {
+				inq ^= 1U;
+			} else if (inq) {
+				;
+			} else if (nd++ == fn) {
+				f->off = beg;
+				f->len = j - beg;
+				return 0;
+			} else if (nd == fn) {
+				beg = j + 1U;
+			}
+		}
+	}
+	if (nd < fn) {
+		return -1;
+	}
+	f->off = beg;
+	f->len = len - beg;
+	return 0;
+}
+
+const char*
+fld_str(char *restrict buf, size_t bsz, const char *str, size_t *len)
+{
+	size_t n = *len;
+	size_t o = 0U;
+
+	if (n < 2U || str[0U] != '"' || str[n - 1U] != '"') {
+		return str;
+	}
+	str++, n -= 2U;
+	if (LIKELY(memchr(str, '"', n) == NULL) || UNLIKELY(n > bsz)) {
+		/* overlong fields are left to the checkers to reject */
+		*len = n;
+		return str;
+	}
+	for (size_t i = 0U; i < n; i++) {
+		buf[o++] = str[i];
+		i += str[i] == '"' && i + 1U < n && str[i + 1U] == '"';
+	}
+	*len = o;
+	return buf;
+}
+
+/* fld.c ends here */
@@ -0,0 +1,62 @@
+/*** fld.h -- delimited field scanner
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_fld_h_
+#define INCLUDED_fld_h_
+
+#include <stddef.h>
+
+struct fld_s {
+	size_t off;
+	size_t len;
+};
+
+/**
+ * Find field FN, counting from 0, in line STR of LEN bytes whose fields
+ * are separated by DLM.  Double quotes protect delimiters as in CSV.
+ * Return 0 and put the offset and length of the field, quotes included,
+ * into F, or return -1 if the line has fewer fields. */
+extern int fld_find(struct fld_s *restrict f,
+		    const char *str, size_t len, char dlm, size_t fn);
+
+/**
+ * Return the contents of field STR of *LEN bytes without its enclosing
+ * quotes, doubled quotes are collapsed into BUF of BSZ bytes if need be.
+ * *LEN is updated accordingly. */
+extern const char *fld_str(char *restrict buf, size_t bsz,
+			   const char *str, size_t *len);
+
+#endif	/* INCLUDED_fld_h_ */
@@ -0,0 +1,214 @@
+/*** fmt.h -- buffer formatting helpers
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_fmt_h_
+#define INCLUDED_fmt_h_
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "numchk.h"
+
+/* append string literal S to BP */
+#define fmt_lit(bp, s)	(memcpy(bp, s, sizeof(s) - 1U), (bp) + sizeof(s) - 1U)
+
+static inline char*
+fmt_mem(char *restrict bp, const char *s, size_t n)
+{
+	memcpy(bp, s, n);
+	return bp + n;
+}
+
+static inline char*
+fmt_str(char *restrict bp, const char *s)
+{
+	return fmt_mem(bp, s, strlen(s));
+}
+
+static inline char*
+fmt_u(char *restrict bp, unsigned int u)
+{
+	char tmp[3U * sizeof(u)];
+	size_t i = sizeof(tmp);
+
+	do {
+		tmp[--i] = (char)(u % 10U ^ '0');
+	} while (u /= 10U);
+	return fmt_mem(bp, tmp + i, sizeof(tmp) - i);
+}
+
+static inline char*
+fmt_zu(char *restrict bp, size_t u)
+{
+	char tmp[3U * sizeof(u)];
+	size_t i = sizeof(tmp);
+
+	do {
+		tmp[--i] = (char)(u % 10U ^ '0');
+	} while (u /= 10U);
+	return fmt_mem(bp, tmp + i, sizeof(tmp) - i);
+}
+
+static inline size_t
+fmt_u8len(const unsigned char *s, size_t n)
+{
+/* length of the well-formed UTF-8 sequence at S, or 0 if there's none,
+ * overlong forms, surrogates and code points beyond U+10FFFF included */
+	unsigned char lo = 0x80U, hi = 0xbfU;
+	size_t z;
+
+	switch (*s) {
+	case 0xc2U ... 0xdfU:
+		z = 2U;
+		break;
+	case 0xe0U:
+		lo = 0xa0U;
+		/*@fallthrough@*/
+	case 0xe1U ... 0xecU:
+	case 0xeeU ... 0xefU:
+		z = 3U;
+		break;
+	case 0xedU:
+		hi = 0x9fU;
+		z = 3U;
+		break;
+	case 0xf0U:
+		lo = 0x90U;
+		/*@fallthrough@*/
+	case 0xf1U ... 0xf3U:
+		z = 4U;
+		break;
+	case 0xf4U:
+		hi = 0x8fU;
+		z = 4U;
+		break;
+	default:
+		return 0U;
+	}
+	if (UNLIKELY(n < z || s[1U] < lo || s[1U] > hi)) {
+		return 0U;
+	}
+	for (size_t i = 2U; i < z; i++) {
+		if (UNLIKELY((s[i] & 0xc0U) != 0x80U)) {
+			return 0U;
+		}
+	}
+	return z;
+}
+
+/* append N bytes of S as JSON string contents, needs room for 6 * N,
+ * bytes that aren't UTF-8 become U+FFFD */
+static inline char*
+fmt_jstr(char *restrict bp, const char *s, size_t n)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	for (size_t i = 0U; i < n; i++) {
+		const unsigned char c = (unsigned char)s[i];
+
+		switch (c) {
+		case '"':
+		case '\\':
+			*bp++ = '\\';
+			*bp++ = (char)c;
+			break;
+		case '\b':
+			bp = fmt_lit(bp, "\\b");
+			break;
+		case '\f':
+			bp = fmt_lit(bp, "\\f");
+			break;
+		case '\n':
+			bp = fmt_lit(bp, "\\n");
+			break;
+		case '\r':
+			bp = fmt_lit(bp, "\\r");
+			break;
+		case '\t':
+			bp = fmt_lit(bp, "\\t");
+			break;
+		case 0x00U ... 0x07U:
+		case 0x0bU:
+		case 0x0eU ... 0x1fU:
+		case 0x7fU:
+			bp = fmt_lit(bp, "\\u00");
+			*bp++ = hex[c >> 4U];
+			*bp++ = hex[c & 0xfU];
+			break;
+		case 0x80U ... 0xffU: {
+			const size_t z = fmt_u8len(
+				(const unsigned char*)s + i, n - i);
+
+			if (UNLIKELY(!z)) {
+				bp = fmt_lit(bp, "\\ufffd");
+				break;
+			}
+			bp = fmt_mem(bp, s + i, z);
+			i += z - 1U;
+			break;
+		}
+		default:
+			*bp++ = (char)c;
+			break;
+		}
+	}
+	return bp;
+}
+
+/* stdout printing in terms of a formatter */
+static inline void
+nmpr_fmt(size_t(*fmt)(char*, nmck_t, const char*, size_t),
+	 nmck_t s, const char *str, size_t len)
+{
+	char buf[256U];
+	char *bp = buf;
+	size_t z;
+
+	if (len + NMFMT_SLACK > sizeof(buf) &&
+	    (bp = malloc(len + NMFMT_SLACK)) == NULL) {
+		return;
+	}
+	/* formatters may well write nothing */
+	if ((z = fmt(bp, s, str, len))) {
+		fwrite(bp, sizeof(*bp), z, stdout);
+	}
+	if (bp != buf) {
+		free(bp);
+	}
+	return;
+}
+
+#endif	/* INCLUDED_fmt_h_ */
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static inline __attribute__((pure, const)) unsigned char
 _cb36(char c)
@@ -92,11 +93,13 @@ nmck_grid(const char *str, size_t len)
 		sum %= 37U;
 		j++;
 	}
-	if (str[i] == '-') {
+	if (i < len && str[i] == '-') {
 		i++;
 	}
 	chk = _b36c(37U - sum);
-	stc = str[i++];
+	/* the check character might be missing altogether */
+	stc = i < len ? str[i] : '\0';
+	i++;
 
 	if (i < len) {
 		return -1;
@@ -105,18 +108,27 @@ nmck_grid(const char *str, size_t len)
 	return chk << 1U | (chk != stc);
 }
 
-void
-nmpr_grid(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_grid(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("GRid, conformant", stdout);
+		bp = fmt_lit(bp, "GRid, conformant");
 	} else if (s > 0 && len > 8U) {
-		fputs("GRid, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7FU, stdout);
+		bp = fmt_lit(bp, "GRid, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7FU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_grid(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_grid, s, str, len);
 	return;
 }
 
@@ -38,7 +38,10 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "state.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 typedef enum {
 	GS1_UNK,
@@ -65,17 +68,14 @@ static const char *types[] = {
 %%{
 	machine numchk;
 
-	gtin = digit{7,17} (digit | check) %{c(gtin)} ;
+	gtin = digit{7,17} (digit | check) %{cd(gtin)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
 
-nmck_t
-nmck_gtin(const char *str, size_t len)
+static inline gs1_type_t
+gs1_type(size_t len)
 {
-/* weights are ... , 1, 3, 1, 3, 1, mod 10
- * subtracting 10 is ..., 9, 7, 9, 7, 9 */
-	uint_fast32_t s1 = 0U, s2 = 0U;
 	gs1_type_t t = GS1_UNK;
 
 	switch (len) {
@@ -93,6 +93,20 @@ nmck_gtin(const char *str, size_t len)
 		t++;
 		break;
 	default:
+		return GS1_UNK;
+	}
+	return (gs1_type_t)(GS1_NTYPES - t);
+}
+
+nmck_t
+nmck_gtin(const char *str, size_t len)
+{
+/* weights are ... , 1, 3, 1, 3, 1, mod 10
+ * subtracting 10 is ..., 9, 7, 9, 7, 9 */
+	uint_fast32_t s1 = 0U, s2 = 0U;
+	gs1_type_t t;
+
+	if ((t = gs1_type(len)) == GS1_UNK) {
 		return -1;
 	}
 
@@ -123,28 +137,77 @@ nmck_gtin(const char *str, size_t len)
 	s1 += s2;
 	s1 %= 10U;
 	s1 ^= '0';
-	return (s1 << 8U ^ (GS1_NTYPES - t)) << 1U ^ ((char)s1 != str[len - 1U]);
+	return (s1 << 8U ^ t) << 1U ^ ((char)s1 != str[len - 1U]);
 }
 
-void
-nmpr_gtin(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_gtin(const struct nmdg_s *dg, const char *str, size_t len)
 {
+/* the last payload digit has the weight 7 */
+	uint_fast32_t sum = 9U * dg->s[1U] + 7U * dg->s[0U];
+	gs1_type_t t;
+
+	if ((t = gs1_type(len)) == GS1_UNK) {
+		return -1;
+	}
+	sum %= 10U;
+	sum ^= '0';
+	return (sum << 8U ^ t) << 1U ^ ((char)sum != str[len - 1U]);
+}
+
+size_t
+nmfmt_gtin(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
 	gs1_type_t t = (gs1_type_t)(s >> 1U & 0xfU);
 
 	if (UNLIKELY(s < 0 || !t || t >= GS1_NTYPES)) {
-		fputs("unknown", stdout);
-		return;
+		bp = fmt_lit(bp, "unknown");
+		return bp - buf;
 	}
 
-	fputs(types[t], stdout);
+	bp = fmt_str(bp, types[t]);
 	if (LIKELY(!(s & 0b1U))) {
-		fputs(", conformant", stdout);
+		bp = fmt_lit(bp, ", conformant");
 	} else if (s > 0 && len > 0) {
-		fputs(", not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 8U >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, ", not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 8U >> 1U & 0x7fU);
 	}
+	return bp - buf;
+}
+
+void
+nmpr_gtin(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_gtin, s, str, len);
 	return;
 }
 
+
+/* incremental, S[0] is the sum with weight 1 for the last digit and S[1]
+ * with weight 3, appending a digit swaps roles */
+int
+gtin_feed(struct nmck_state *st, char c)
+{
+	const unsigned int d = (unsigned char)(c ^ '0');
+	const unsigned int s0 = st->s[0U];
+
+	if (UNLIKELY(d >= 10U)) {
+		return -1;
+	}
+	st->s[0U] = (st->s[1U] + d) % 10U;
+	st->s[1U] = (s0 + 3U * d) % 10U;
+	return 0;
+}
+
+int
+gtin_final(const struct nmck_state *st)
+{
+	if (st->len < 2U) {
+		return -1;
+	}
+	return st->s[0U] != 0U;
+}
+
 /* gtin.c ends here */
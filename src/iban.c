@@ -39,7 +39,10 @@
 #include <stdio.h>
 #include <assert.h>
 #include "numchk.h"
+#include "mod97.h"
+#include "state.h"
 #include "nifty.h"
+#include "fmt.h"
 
 /* here we register all allowed country codes, as per
  * http://www.nordea.com/Our+services/Cash+Management/Products+and+services/IBAN+countries/908462.html */
@@ -60,11 +63,10 @@
 nmck_t
 nmck_iban(const char *str, size_t len)
 {
-	uint_fast8_t buf[78U];
-	size_t bsz = 0U;
 	char chk[2U];
-	uint_fast32_t sum = 0U;
-	size_t j = 0U;
+	uint_fast32_t sum;
+	size_t j;
+	int r;
 
 	/* common cases first */
 	if (len < 15U || len > 34U) {
@@ -73,84 +75,18 @@ nmck_iban(const char *str, size_t len)
 		return -1;
 	}
 
-	/* expand string first */
-	for (size_t i = 4U; i < len; i++) {
-		switch (str[i]) {
-		case ' ':
-			continue;
-		case '0' ... '9':
-			buf[bsz++] = (unsigned char)(str[i] ^ '0');
-			j++;
-			break;
-		case 'A' ... 'J':
-			buf[bsz++] = 1U;
-			buf[bsz++] = (unsigned char)(str[i] - 'A');
-			j++;
-			break;
-		case 'K' ... 'T':
-			buf[bsz++] = 2U;
-			buf[bsz++] = (unsigned char)(str[i] - 'K');
-			j++;
-			break;
-		case 'U' ... 'Z':
-			buf[bsz++] = 3U;
-			buf[bsz++] = (unsigned char)(str[i] - 'U');
-			j++;
-			break;
-		default:
-			return -1;
-		}
-	}
-	/* append the country code */
-	switch (str[0U]) {
-	case 'A' ... 'J':
-		buf[bsz++] = 1U;
-		buf[bsz++] = (unsigned char)(str[0U] - 'A');
-		break;
-	case 'K' ... 'T':
-		buf[bsz++] = 2U;
-		buf[bsz++] = (unsigned char)(str[0U] - 'K');
-		break;
-	case 'U' ... 'Z':
-		buf[bsz++] = 3U;
-		buf[bsz++] = (unsigned char)(str[0U] - 'U');
-		break;
-	default:
-		return -1;
-	}
-	switch (str[1U]) {
-	case 'A' ... 'J':
-		buf[bsz++] = 1U;
-		buf[bsz++] = (unsigned char)(str[1U] - 'A');
-		break;
-	case 'K' ... 'T':
-		buf[bsz++] = 2U;
-		buf[bsz++] = (unsigned char)(str[1U] - 'K');
-		break;
-	case 'U' ... 'Z':
-		buf[bsz++] = 3U;
-		buf[bsz++] = (unsigned char)(str[1U] - 'U');
-		break;
-	default:
+	/* BBAN first, then the country code and 00 */
+	if (UNLIKELY((r = mod97_fold(0U, str + 4U, len - 4U, ' ', &j)) < 0)) {
 		return -1;
 	}
-	/* and 00 */
-	buf[bsz++] = 0U;
-	buf[bsz++] = 0U;
+	r = mod97_fold((unsigned int)r, str, 2U, -1, NULL);
+	sum = (uint_fast32_t)r * 100U % 97U;
 
 	/* check length for country */
 	if (UNLIKELY(cc_len(str) != j + 4U)) {
 		return -1;
 	}
 
-	/* now calc first sum */
-	sum = buf[0U] * 10U + buf[1U];
-	for (size_t i = 2U; i < bsz; sum %= 97U) {
-		for (const size_t n = i + 7U < bsz ? i + 7U : bsz; i < n; i++) {
-			sum *= 10U;
-			sum += buf[i];
-		}
-	}
 	/* this is the actual checksum */
 	sum = 98U - sum;
 	chk[0U] = (char)((sum / 10U) ^ '0');
@@ -161,22 +97,65 @@ nmck_iban(const char *str, size_t len)
 		(chk[0U] != str[2U] || chk[1U] != str[3U]);
 }
 
-void
-nmpr_iban(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_iban(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("IBAN, conformant with ISO 13616-1:2007", stdout);
+		bp = fmt_lit(bp, "IBAN, conformant with ISO 13616-1:2007");
 	} else if (s > 0 && len >= 4U) {
-		fputs("IBAN, not ISO 13616-1 conformant, should be ", stdout);
-		fputc(str[0U], stdout);
-		fputc(str[1U], stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
-		fputc(s >> 8U & 0x7fU, stdout);
-		fwrite(str + 4U, sizeof(*str), len - 4U, stdout);
+		bp = fmt_lit(bp, "IBAN, not ISO 13616-1 conformant, should be ");
+		*bp++ = (char)(str[0U]);
+		*bp++ = (char)(str[1U]);
+		*bp++ = (char)(s >> 16U & 0x7fU);
+		*bp++ = (char)(s >> 8U & 0x7fU);
+		bp = fmt_mem(bp, str + 4U, len - 4U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_iban(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_iban, s, str, len);
 	return;
 }
 
+
+/* incremental, S[0] is the remainder so far, for the rotating variant
+ * the first 4 characters are kept aside and folded in at the end */
+int
+mod97_feed(struct nmck_state *st, char c)
+{
+	const unsigned int v = mod97_val(c);
+
+	if (UNLIKELY(v >= 36U)) {
+		return -1;
+	} else if (st->algo == NMCK_ALGO_MOD97_ROT4 && st->len < 4U) {
+		st->head[st->len] = c;
+		return 0;
+	}
+	st->s[0U] = (st->s[0U] * (v < 10U ? 10U : 100U) + v) % 97U;
+	return 0;
+}
+
+int
+mod97_final(const struct nmck_state *st)
+{
+	unsigned int r = st->s[0U];
+
+	if (st->algo == NMCK_ALGO_MOD97_ROT4) {
+		if (st->len < 5U) {
+			return -1;
+		}
+		r = (unsigned int)mod97_fold(r, st->head, 4U, -1, NULL);
+	} else if (st->len < 3U) {
+		return -1;
+	}
+	return r != 1U;
+}
+
 /* iban.c ends here */
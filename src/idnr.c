@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -79,18 +80,27 @@ nmck_idnr(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_idnr(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_idnr(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("IdNr, conformant", stdout);
+		bp = fmt_lit(bp, "IdNr, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("IdNr, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "IdNr, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_idnr(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_idnr, s, str, len);
 	return;
 }
 
@@ -40,13 +40,16 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "luhn.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
 	machine numchk;
 
-	imei = digit{2} "-"? digit{6} "-"? digit{6} "-"? ((digit | check) | digit{2}) %{c(imei)} ;
+	imei = digit{2} "-"? digit{6} "-"? digit{6} "-"? ((digit | check) | digit{2}) %{cd(imei)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -56,27 +59,32 @@ nmck_imei(const char *str, size_t len)
 {
 /* Luhn */
 	uint_fast32_t sum = 0U;
-	uint_fast32_t w = 1U;
-	size_t j = 0U;
+	size_t j = len - 1U;
+	int ls;
 
 	if (UNLIKELY(len < 14U || len > 18U)) {
 		return -1;
-	}
+	} else if (LIKELY((ls = luhn_sum(str, j, !(j & 0b1U))) >= 0)) {
+		/* plain digits, weights go 1, 2, 1, ... from the left */
+		sum = (uint_fast32_t)ls;
+	} else {
+		uint_fast32_t w = 1U;
 
-	for (size_t i = 0U; i < len - 1U; i++) {
-		uint_fast32_t c = (unsigned char)(str[i] ^ '0');
+		for (size_t i = j = 0U; i < len - 1U; i++) {
+			uint_fast32_t c = (unsigned char)(str[i] ^ '0');
 
-		if (str[i] == '-') {
-			continue;
-		} else if (UNLIKELY(c >= 18U)) {
-			return -1;
-		}
-		with (uint_fast32_t x = c * w) {
-			sum += x;
-			sum += (x >= 10U);
+			if (str[i] == '-') {
+				continue;
+			} else if (UNLIKELY(c >= 18U)) {
+				return -1;
+			}
+			with (uint_fast32_t x = c * w) {
+				sum += x;
+				sum += (x >= 10U);
+			}
+			w ^= 3U;
+			j++;
 		}
-		w ^= 3U;
-		j++;
 	}
 	if (j > 14U) {
 		return 0U;
@@ -89,22 +97,52 @@ nmck_imei(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_imei(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_imei(const struct nmdg_s *dg, const char *str, size_t len)
 {
+/* weights go 1, 2, 1, ... from the left */
+	uint_fast32_t sum;
+
+	if (UNLIKELY(len < 14U || len > 18U)) {
+		return -1;
+	} else if (len - 1U > 14U) {
+		return 0U;
+	}
+	sum = len & 0b1U
+		? dg->l[0U] + dg->s[1U]
+		: dg->s[0U] + dg->l[1U];
+	sum %= 10U;
+	sum = 10 - sum;
+	sum %= 10U;
+	sum ^= '0';
+	return sum << 1U ^ ((char)sum != str[len - 1U]);
+}
+
+size_t
+nmfmt_imei(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (!(s & 0b1U) && (s >> 1U)) {
-		fputs("IMEI, GSMA conformant", stdout);
+		bp = fmt_lit(bp, "IMEI, GSMA conformant");
 	} else if (s == 0U) {
-		fputs("IMEISV, GSMA conformant", stdout);
+		bp = fmt_lit(bp, "IMEISV, GSMA conformant");
 	} else if (s > 1U) {
-		fputs("IMEI, not GSMA conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "IMEI, not GSMA conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else if (s == 1U) {
-		fputs("IMEISV, not GSMA conformant", stdout);
+		bp = fmt_lit(bp, "IMEISV, not GSMA conformant");
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_imei(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_imei, s, str, len);
 	return;
 }
 
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -84,18 +85,27 @@ nmck_imo(const char *str, size_t len)
 	return sum << 1U ^ (str[of + 6U] != (char)sum);
 }
 
-void
-nmpr_imo(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_imo(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("IMO, conformant", stdout);
+		bp = fmt_lit(bp, "IMO, conformant");
 	} else if (s > 0 && len > 0) {
-		fputs("IMO, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7FU, stdout);
+		bp = fmt_lit(bp, "IMO, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7FU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_imo(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_imo, s, str, len);
 	return;
 }
 
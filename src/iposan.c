@@ -43,6 +43,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static const uint_fast8_t damm[10U][10U] = {
 	[0] = {0, 3, 1, 7, 5, 9, 8, 6, 4, 2},
@@ -100,19 +101,28 @@ nmck_iposan(const char *str, size_t len)
 	return prod << 1U ^ ((char)prod != str[11U]);
 }
 
-void
-nmpr_iposan(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_iposan(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("IPOS application number, conformant", stdout);
+		bp = fmt_lit(bp, "IPOS application number, conformant");
 	} else if (s > 0 && len >= 12U) {
-		fputs("IPOS application number, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 11U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
-		fwrite(str + 12U, sizeof(*str), len - 12U, stdout);
+		bp = fmt_lit(bp, "IPOS application number, not conformant, should be ");
+		bp = fmt_mem(bp, str, 11U);
+		*bp++ = (char)(s >> 1 & 0x7f);
+		bp = fmt_mem(bp, str + 12U, len - 12U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_iposan(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_iposan, s, str, len);
 	return;
 }
 
@@ -41,6 +41,7 @@
 #include <stdint.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static __attribute__((pure, const)) uint_fast32_t
 _chex(char c)
@@ -108,7 +109,7 @@ nmck_isan(const char *str, size_t len)
 		sum %= 37U;
 		j++;
 	}
-	i += str[i] == '-';
+	i += i < len && str[i] == '-';
 	chk[0U] = _b36c(37U - sum);
 	pos = i++;
 
@@ -136,26 +137,36 @@ nmck_isan(const char *str, size_t len)
 	}
 
 	return ((chk[0U] << 8U ^ chk[1U]) << 8U ^ pos) << 8U ^
-		(chk[0U] != str[pos] || chk[1U] != str[i - 1U]);
+		(pos >= len || chk[0U] != str[pos] ||
+		 i > len || chk[1U] != str[i - 1U]);
 }
 
-void
-nmpr_isan(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_isan(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISAN, conformant", stdout);
+		bp = fmt_lit(bp, "ISAN, conformant");
 	} else if (s > 0 && len > 0) {
 		size_t pos = s >> 8U & 0x7fU;
-		fputs("ISAN, not conformant, should be ", stdout);
-		fwrite(str, 1, pos, stdout);
-		fputc(s >> 24U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISAN, not conformant, should be ");
+		bp = fmt_mem(bp, str, pos);
+		*bp++ = (char)(s >> 24U & 0x7fU);
 		if (pos + 1U < len) {
-			fwrite(str + pos + 1, 1, len - (pos + 1U) - 1U, stdout);
-			fputc(s >> 16U & 0x7fU, stdout);
+			bp = fmt_mem(bp, str + pos + 1, len - (pos + 1U) - 1U);
+			*bp++ = (char)(s >> 16U & 0x7fU);
 		}
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isan(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isan, s, str, len);
 	return;
 }
 
@@ -38,7 +38,10 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "state.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 enum {
 	ISBN_UNK,
@@ -60,7 +63,7 @@ isbn13p(const char *str, size_t len)
 
 	isbn =
 		/97[89]/ "-"? digit "-"? digit{4} "-"? digit{4} "-"? (digit | check) %{c(isbn13)} |
-		digit "-"? digit{4} "-"? digit{4} "-"? (digit | "X" | check) %{c(isbn10)} ;
+		digit "-"? digit{4} "-"? digit{4} "-"? (digit | "X" | check) %{cd(isbn10)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -90,18 +93,41 @@ nmck_isbn10(const char *str, size_t len)
 	return ((sum << 8U) ^ ISBN10) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_isbn10(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_isbn10(const struct nmdg_s *dg, const char *str, size_t len)
 {
+	uint_fast32_t sum = dg->w;
+
+	if (UNLIKELY(len < 10U || len > 13U)) {
+		return -1;
+	}
+	sum %= 11U;
+	sum ^= sum < 10U ? '0' : 'R'/*0xA^'X'*/;
+
+	return ((sum << 8U) ^ ISBN10) << 8U ^ ((char)sum != str[len - 1U]);
+}
+
+size_t
+nmfmt_isbn10(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISBN, conformant with ISO 2108:1992", stdout);
+		bp = fmt_lit(bp, "ISBN, conformant with ISO 2108:1992");
 	} else if (s > 0 && len > 0) {
-		fputs("ISBN, not ISO 2108:1992 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISBN, not ISO 2108:1992 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isbn10(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isbn10, s, str, len);
 	return;
 }
 
@@ -142,18 +168,27 @@ nmck_isbn13(const char *str, size_t len)
 	return ((sum << 8U) ^ ISBN13) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_isbn13(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_isbn13(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISBN, conformant with ISO 2108:2005", stdout);
+		bp = fmt_lit(bp, "ISBN, conformant with ISO 2108:2005");
 	} else if (s > 0 && len > 0) {
-		fputs("ISBN, not ISO 2108:2005 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISBN, not ISO 2108:2005 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isbn13(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isbn13, s, str, len);
 	return;
 }
 
@@ -163,41 +198,84 @@ nmck_isbn(const char *str, size_t len)
 	return isbn13p(str, len) ? nmck_isbn13(str, len) : nmck_isbn10(str, len);
 }
 
-void
-nmpr_isbn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_isbn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (UNLIKELY(s < 0)) {
 	unk:
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	} else if (LIKELY(!(s & 0b1U))) {
-		fputs("ISBN, conformant with ", stdout);
+		bp = fmt_lit(bp, "ISBN, conformant with ");
 		switch (s >> 8U & 0x7fU) {
 		case ISBN13:
-			fputs("ISO 2108:2005", stdout);
+			bp = fmt_lit(bp, "ISO 2108:2005");
 			break;
 		case ISBN10:
-			fputs("ISO 2108:1992", stdout);
+			bp = fmt_lit(bp, "ISO 2108:1992");
 			break;
 		default:
 			goto unk;
 		}
 	} else if (len > 0) {
-		fputs("ISBN, not ", stdout);
+		bp = fmt_lit(bp, "ISBN, not ");
 		switch (s >> 8U & 0x7fU) {
 		case ISBN13:
-			fputs("ISO 2108:2005", stdout);
+			bp = fmt_lit(bp, "ISO 2108:2005");
 			break;
 		case ISBN10:
-			fputs("ISO 2108:1992", stdout);
+			bp = fmt_lit(bp, "ISO 2108:1992");
 			break;
 		default:
 			break;
 		}
-		fputs(" conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, " conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isbn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isbn, s, str, len);
 	return;
 }
 
+
+/* incremental, with digits D[k] for k = 0, ..., n - 1 from the left the
+ * weighted sum is n * S[0] - S[1] where S[0] sums up D[k] and S[1] sums
+ * up k * D[k], everything mod 11; only the last character may be an X,
+ * S[2] is set once there was one */
+int
+isbn_feed(struct nmck_state *st, char c)
+{
+	unsigned int d = (unsigned char)(c ^ '0');
+
+	if (UNLIKELY(st->s[2U])) {
+		/* nothing after an X */
+		return -1;
+	} else if (UNLIKELY(d >= 10U)) {
+		if ((c | 0x20) != 'x') {
+			return -1;
+		}
+		st->s[2U] = 1U;
+		d = 10U;
+	}
+	st->s[0U] = (st->s[0U] + d) % 11U;
+	st->s[1U] = (st->s[1U] + st->len % 11U * d) % 11U;
+	return 0;
+}
+
+int
+isbn_final(const struct nmck_state *st)
+{
+	if (st->len < 2U) {
+		return -1;
+	}
+	return (st->len % 11U * st->s[0U] + 11U - st->s[1U]) % 11U != 0U;
+}
+
 /* isbn.c ends here */
@@ -40,7 +40,9 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "luhn.h"
 #include "nifty.h"
+#include "fmt.h"
 
 /* allowed isin country codes */
 #include "isin-cc.c"
@@ -53,54 +55,60 @@
 }%%
 #endif	/* RAGEL_BLOCK */
 
+static inline __attribute__((const)) uint_fast32_t
+luhn_dbl(uint_fast32_t c)
+{
+	return 2U * c - (c >= 5U) * 9U;
+}
+
+static inline __attribute__((const)) uint_fast32_t
+ltr_sum(char c, unsigned int dbl)
+{
+/* Luhn sum of the expansion of letter C, which is 10 + C - 'A', whose
+ * ones digit is doubled iff DBL is set, its tens digit iff not */
+	const uint_fast32_t x = (unsigned char)(c - 'A' + 10);
+
+	return dbl ? x / 10U + luhn_dbl(x % 10U) : luhn_dbl(x / 10U) + x % 10U;
+}
+
 
 nmck_t
 nmck_isin(const char *str, size_t len)
 {
-	uint_fast8_t buf[24U];
-	size_t bsz = 0U;
-	/* for the luhn check */
-	uint_fast32_t dbl[2U] = {0U, 0U};
-	uint_fast32_t one[2U] = {0U, 0U};
 	uint_fast32_t sum;
-	size_t k;
+	int x;
 
 	if (UNLIKELY(len != 12U)) {
 		return -1;
 	} else if (!valid_cc_p(str)) {
 		return -1;
-	}
+	} else if (LIKELY((x = luhn_sum(str + 2U, 9U, 1U)) >= 0)) {
+		/* all-digit NSIN, the country code expands to 4 digits
+		 * to the left of it so the tens digits are doubled */
+		sum = (uint_fast32_t)x;
+		sum += ltr_sum(str[0U], 0U) + ltr_sum(str[1U], 0U);
+	} else {
+		/* go right to left, letters expand to two digits and
+		 * therefore don't change the doubling of their neighbours */
+		size_t k = 1U;
 
-	/* expand the left 11 digits */
-	for (size_t i = 0U; i < 11U; i++) {
-		switch (str[i]) {
-		case '0' ... '9':
-			buf[bsz++] = (unsigned char)(str[i] ^ '0');
-			break;
-		case 'A' ... 'J':
-			buf[bsz++] = 1U;
-			buf[bsz++] = (unsigned char)(str[i] - 'A');
-			break;
-		case 'K' ... 'T':
-			buf[bsz++] = 2U;
-			buf[bsz++] = (unsigned char)(str[i] - 'K');
-			break;
-		case 'U' ... 'Z':
-			buf[bsz++] = 3U;
-			buf[bsz++] = (unsigned char)(str[i] - 'U');
-			break;
-		default:
-			return -1;
+		sum = 0U;
+		for (size_t i = 11U; i-- > 0U;) {
+			switch (str[i]) {
+			case '0' ... '9':
+				with (uint_fast32_t c = str[i] ^ '0') {
+					sum += k ? luhn_dbl(c) : c;
+				}
+				k ^= 1U;
+				break;
+			case 'A' ... 'Z':
+				sum += ltr_sum(str[i], k);
+				break;
+			default:
+				return -1;
+			}
 		}
 	}
-
-	for (size_t i = k = 0U; i < bsz; i++, k ^= 1U) {
-		uint_fast32_t c = 2U * buf[i];
-		dbl[k] += c;
-		one[k] += c >= 10U;
-	}
-	/* decide now which sum was the 2-weighted one */
-	sum = dbl[k] / 2U + dbl[k ^ 1U] + one[k ^ 1U];
 	sum = 10000U - sum;
 	sum %= 10;
 	sum ^= '0';
@@ -108,18 +116,27 @@ nmck_isin(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_isin(nmck_t s, const char *sr, size_t len)
+size_t
+nmfmt_isin(char *restrict buf, nmck_t s, const char *sr, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("ISIN, conformant with ISO 6166:2013", stdout);
+		bp = fmt_lit(bp, "ISIN, conformant with ISO 6166:2013");
 	} else if (s > 0 && len == 12U) {
-		fputs("ISIN, not ISO 6166 conformant, should be ", stdout);
-		fwrite(sr, sizeof(*sr), 11U, stdout);
-		fputc(s >> 1 & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISIN, not ISO 6166 conformant, should be ");
+		bp = fmt_mem(bp, sr, 11U);
+		*bp++ = (char)(s >> 1 & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isin(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isin, s, str, len);
 	return;
 }
 
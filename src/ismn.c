@@ -39,6 +39,7 @@
 #include <stdio.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 enum {
 	ISMN_UNK,
@@ -93,18 +94,27 @@ nmck_ismn10(const char *str, size_t len)
 	return (sum << 8U ^ ISMN10) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_ismn10(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ismn10(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISMN, conformant with ISO 10957:1993", stdout);
+		bp = fmt_lit(bp, "ISMN, conformant with ISO 10957:1993");
 	} else if (s > 0 && len > 0) {
-		fputs("ISMN, not ISO 10957:1993 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISMN, not ISO 10957:1993 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ismn10(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ismn10, s, str, len);
 	return;
 }
 
@@ -145,18 +155,27 @@ nmck_ismn13(const char *str, size_t len)
 	return ((sum << 8U) ^ ISMN13) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_ismn13(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ismn13(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISMN, conformant with ISO 10957:2009", stdout);
+		bp = fmt_lit(bp, "ISMN, conformant with ISO 10957:2009");
 	} else if (s > 0 && len > 0) {
-		fputs("ISMN, not ISO 10957:2009 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISMN, not ISO 10957:2009 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ismn13(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ismn13, s, str, len);
 	return;
 }
 
@@ -166,40 +185,49 @@ nmck_ismn(const char *str, size_t len)
 	return ismn13p(str, len) ? nmck_ismn13(str, len) : nmck_ismn10(str, len);
 }
 
-void
-nmpr_ismn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ismn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (UNLIKELY(s < 0)) {
 	unk:
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	} else if (LIKELY(!(s & 0b1U))) {
-		fputs("ISMN, conformant with ", stdout);
+		bp = fmt_lit(bp, "ISMN, conformant with ");
 		switch (s >> 8U & 0x7fU) {
 		case ISMN13:
-			fputs("ISO 10957:2009", stdout);
+			bp = fmt_lit(bp, "ISO 10957:2009");
 			break;
 		case ISMN10:
-			fputs("ISO 10957:1993", stdout);
+			bp = fmt_lit(bp, "ISO 10957:1993");
 			break;
 		default:
 			goto unk;
 		}
 	} else if (len > 0) {
-		fputs("ISMN, not ", stdout);
+		bp = fmt_lit(bp, "ISMN, not ");
 		switch (s >> 8U & 0x7fU) {
 		case ISMN13:
-			fputs("ISO 10957:2009", stdout);
+			bp = fmt_lit(bp, "ISO 10957:2009");
 			break;
 		case ISMN10:
-			fputs("ISO 10957:1993", stdout);
+			bp = fmt_lit(bp, "ISO 10957:1993");
 			break;
 		default:
 			break;
 		}
-		fputs(" conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16 & 0x7fU, stdout);
+		bp = fmt_lit(bp, " conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16 & 0x7fU);
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ismn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ismn, s, str, len);
 	return;
 }
 
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -80,18 +81,27 @@ nmck_isni(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_isni(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_isni(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISNI, conformant with ISO 27729:2012", stdout);
+		bp = fmt_lit(bp, "ISNI, conformant with ISO 27729:2012");
 	} else if (s > 0 && len > 0) {
-		fputs("ISNI, not ISO 27729:2012 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISNI, not ISO 27729:2012 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_isni(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_isni, s, str, len);
 	return;
 }
 
@@ -39,6 +39,7 @@
 #include <stdio.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 enum {
 	ISSN_UNK,
@@ -93,18 +94,27 @@ nmck_issn8(const char *str, size_t len)
 	return (sum << 8U ^ ISSN8) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_issn8(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_issn8(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISSN, conformant with ISO 3297:1975", stdout);
+		bp = fmt_lit(bp, "ISSN, conformant with ISO 3297:1975");
 	} else if (s > 0 && len > 0) {
-		fputs("ISSN, not ISO 3297:1975 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISSN, not ISO 3297:1975 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_issn8(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_issn8, s, str, len);
 	return;
 }
 
@@ -145,18 +155,27 @@ nmck_issn13(const char *str, size_t len)
 	return ((sum << 8U) ^ ISSN13) << 8U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_issn13(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_issn13(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISSN, conformant with ISO 3297:2007", stdout);
+		bp = fmt_lit(bp, "ISSN, conformant with ISO 3297:2007");
 	} else if (s > 0 && len > 0) {
-		fputs("ISSN, not ISO 3297:2007 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISSN, not ISO 3297:2007 conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_issn13(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_issn13, s, str, len);
 	return;
 }
 
@@ -166,40 +185,49 @@ nmck_issn(const char *str, size_t len)
 	return issn13p(str, len) ? nmck_issn13(str, len) : nmck_issn8(str, len);
 }
 
-void
-nmpr_issn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_issn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (UNLIKELY(s < 0)) {
 	unk:
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	} else if (LIKELY(!(s & 0b1U))) {
-		fputs("ISSN, conformant with ", stdout);
+		bp = fmt_lit(bp, "ISSN, conformant with ");
 		switch (s >> 8U & 0x7fU) {
 		case ISSN13:
-			fputs("ISO 3297:2007", stdout);
+			bp = fmt_lit(bp, "ISO 3297:2007");
 			break;
 		case ISSN8:
-			fputs("ISO 3297:1975", stdout);
+			bp = fmt_lit(bp, "ISO 3297:1975");
 			break;
 		default:
 			goto unk;
 		}
 	} else if (len > 0) {
-		fputs("ISSN, not ", stdout);
+		bp = fmt_lit(bp, "ISSN, not ");
 		switch (s >> 8U & 0x7fU) {
 		case ISSN13:
-			fputs("ISO 3297:2007", stdout);
+			bp = fmt_lit(bp, "ISO 3297:2007");
 			break;
 		case ISSN8:
-			fputs("ISO 3297:1975", stdout);
+			bp = fmt_lit(bp, "ISO 3297:1975");
 			break;
 		default:
 			break;
 		}
-		fputs(" conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
+		bp = fmt_lit(bp, " conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1);
+		*bp++ = (char)(s >> 16U & 0x7fU);
 	}
+	return bp - buf;
+}
+
+void
+nmpr_issn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_issn, s, str, len);
 	return;
 }
 
@@ -41,6 +41,7 @@
 #include <stdint.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static __attribute__((pure, const)) uint_fast32_t
 _chex(char c)
@@ -153,18 +154,27 @@ nmck_istc(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_istc(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_istc(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("ISTC, conformant", stdout);
+		bp = fmt_lit(bp, "ISTC, conformant");
 	} else if (s > 0 && len > 0) {
-		fputs("ISTC, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "ISTC, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_istc(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_istc, s, str, len);
 	return;
 }
 
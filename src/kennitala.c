@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -106,19 +107,28 @@ nmck_kennitala(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[i]);
 }
 
-void
-nmpr_kennitala(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_kennitala(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("kennitala, conformant", stdout);
+		bp = fmt_lit(bp, "kennitala, conformant");
 	} else if (s > 0 && len > 2U) {
-		fputs("kennitala, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
-		fputc(str[len - 1U], stdout);
+		bp = fmt_lit(bp, "kennitala, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(s >> 1 & 0x7f);
+		*bp++ = (char)(str[len - 1U]);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_kennitala(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_kennitala, s, str, len);
 	return;
 }
 
@@ -40,7 +40,9 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "mod97.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -54,51 +56,18 @@
 nmck_t
 nmck_lei(const char *str, size_t len)
 {
-	uint_fast8_t buf[40U];
-	size_t bsz = 0U;
-	uint_fast32_t sum = 0U;
+	uint_fast32_t sum;
 	char chk[2U];
+	int r;
 
 	/* common cases first */
 	if (len != 20U) {
 		return -1;
-	}
-
-	/* expand string first */
-	for (size_t i = 0U; i < 18U; i++) {
-		switch (str[i]) {
-		case '0' ... '9':
-			buf[bsz++] = (unsigned char)(str[i] ^ '0');
-			break;
-		case 'A' ... 'J':
-			buf[bsz++] = 1U;
-			buf[bsz++] = (unsigned char)(str[i] - 'A');
-			break;
-		case 'K' ... 'T':
-			buf[bsz++] = 2U;
-			buf[bsz++] = (unsigned char)(str[i] - 'K');
-			break;
-		case 'U' ... 'Z':
-			buf[bsz++] = 3U;
-			buf[bsz++] = (unsigned char)(str[i] - 'U');
-			break;
-		default:
-			return -1;
-		}
+	} else if (UNLIKELY((r = mod97_fold(0U, str, 18U, -1, NULL)) < 0)) {
+		return -1;
 	}
 	/* and 00 */
-	buf[bsz++] = 0U;
-	buf[bsz++] = 0U;
-
-	/* now calc first sum */
-	sum = buf[0U] * 10U + buf[1U];
-	for (size_t i = 2U; i < bsz; sum %= 97U) {
-		/* just so we calculate less modulos */
-		for (const size_t n = i + 7U < bsz ? i + 7U : bsz; i < n; i++) {
-			sum *= 10U;
-			sum += buf[i];
-		}
-	}
+	sum = (uint_fast32_t)r * 100U % 97U;
 
 	/* this is the actual checksum */
 	sum = 98U - sum;
@@ -110,19 +79,28 @@ nmck_lei(const char *str, size_t len)
 		(chk[0U] != str[18U] || chk[1U] != str[19U]);
 }
 
-void
-nmpr_lei(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_lei(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("LEI, conformant with ISO 17442:2012", stdout);
+		bp = fmt_lit(bp, "LEI, conformant with ISO 17442:2012");
 	} else if (s > 0 && len == 20U) {
-		fputs("LEI, not ISO 17442 conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 18U, stdout);
-		fputc(s >> 16U & 0x7fU, stdout);
-		fputc(s >> 8U & 0x7fU, stdout);
+		bp = fmt_lit(bp, "LEI, not ISO 17442 conformant, should be ");
+		bp = fmt_mem(bp, str, 18U);
+		*bp++ = (char)(s >> 16U & 0x7fU);
+		*bp++ = (char)(s >> 8U & 0x7fU);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_lei(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_lei, s, str, len);
 	return;
 }
 
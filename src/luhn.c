@@ -38,45 +38,291 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "luhn.h"
+#include "state.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
-
-nmck_t
-nmck_luhn(const char *str, size_t len)
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+# define LUHN_X86
+# include <immintrin.h>
+#elif defined __ARM_NEON && defined __aarch64__
+# define LUHN_NEON
+# include <arm_neon.h>
+#endif	/* __x86_64__ || __i386__ || __aarch64__ */
+
+/* the Luhn value of a doubled digit */
+static const unsigned char luhn_dbl[16U] = {
+	0U, 2U, 4U, 6U, 8U, 1U, 3U, 5U, 7U, 9U,
+};
+
+
+static inline int
+luhn_sum_gen(const char *str, size_t len, unsigned int dbl)
 {
-	uint_fast32_t dbl[2U] = {0U, 0U};
-	uint_fast32_t one[2U] = {0U, 0U};
-	uint_fast32_t sum;
-	size_t k;
+	uint_fast32_t sum[2U] = {0U, 0U};
 
-	if (len < 2U) {
-		/* no need to check single digits, nor no digits */
+	for (size_t i = len, k = dbl & 0b1U; i-- > 0U; k ^= 1U) {
+		uint_fast32_t c = (unsigned char)(str[i] ^ '0');
+
+		if (UNLIKELY(c >= 10U)) {
+			return -1;
+		}
+		sum[k] += k ? luhn_dbl[c] : c;
+	}
+	return (int)(sum[0U] + sum[1U]);
+}
+
+#if defined LUHN_X86
+/* Blocks are processed right to left, straight from STR.  Block widths
+ * are even so the lanes to double are the same in every block: those
+ * at an odd distance to the last lane, or even if DBL is set.
+ * The leftmost partial block is loaded from the start of STR with the
+ * lanes beyond it set to '0', or, if STR is shorter than a block, from
+ * a left-padded scratch copy. */
+static inline __attribute__((target("sse4.1"))) int
+luhn_blk_sse(__m128i *restrict acc, __m128i d, __m128i msk)
+{
+/* add lane sums of digits D, doubled where MSK is set, to ACC */
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i tbl = _mm_loadu_si128((const void*)luhn_dbl);
+
+	d = _mm_sub_epi8(d, _mm_set1_epi8('0'));
+	if (UNLIKELY(_mm_movemask_epi8(
+			     _mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine)) != 0xffff)) {
 		return -1;
 	}
+	d = _mm_blendv_epi8(d, _mm_shuffle_epi8(tbl, d), msk);
+	*acc = _mm_add_epi64(*acc, _mm_sad_epu8(d, _mm_setzero_si128()));
+	return 0;
+}
 
-	for (size_t i = k = 0U; i < len; i++, k ^= 1U) {
-		uint_fast32_t c = (unsigned char)(str[i] ^ '0');
+static inline __attribute__((target("sse4.1"))) int
+luhn_tail_sse(__m128i *restrict acc,
+	      const char *str, size_t i, size_t len, __m128i msk)
+{
+/* the leftmost I < 16 digits of STR of length LEN */
+	char pad[16U];
+	__m128i d;
 
-		if (UNLIKELY(c >= 10U)) {
+	if (len >= sizeof(pad)) {
+		const __m128i idx = _mm_setr_epi8(
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		const __m128i in = _mm_cmpgt_epi8(_mm_set1_epi8((char)i), idx);
+
+		d = _mm_loadu_si128((const void*)str);
+		d = _mm_blendv_epi8(_mm_set1_epi8('0'), d, in);
+		if (len & 0b1U) {
+			/* lane distances to the end of STR flip parity */
+			msk = _mm_xor_si128(msk, _mm_set1_epi8(-1));
+		}
+	} else {
+		memset(pad, '0', sizeof(pad) - i);
+		memcpy(pad + sizeof(pad) - i, str, i);
+		d = _mm_loadu_si128((const void*)pad);
+	}
+	return luhn_blk_sse(acc, d, msk);
+}
+
+static __attribute__((target("sse4.1"))) int
+luhn_sum_sse(const char *str, size_t len, unsigned int dbl)
+{
+	const __m128i msk = _mm_set1_epi16(dbl & 0b1U ? (short)0xff00 : 0x00ff);
+	__m128i acc = _mm_setzero_si128();
+	size_t i;
+
+	for (i = len; i >= 16U; i -= 16U) {
+		const __m128i d = _mm_loadu_si128((const void*)(str + i - 16U));
+
+		if (UNLIKELY(luhn_blk_sse(&acc, d, msk) < 0)) {
 			return -1;
 		}
-		dbl[k] += 2U * c;
-		one[k] += 2U * c >= 10U;
 	}
-	/* decide now which sum was the 2-weighted one */
-	sum = dbl[k ^ 1U] / 2U + dbl[k] + one[k];
-	sum %= 10U;
+	if (i && UNLIKELY(luhn_tail_sse(&acc, str, i, len, msk) < 0)) {
+		return -1;
+	}
+	return _mm_cvtsi128_si32(acc) + _mm_extract_epi32(acc, 2);
+}
 
-	return !sum - 1;
+static __attribute__((target("avx2"))) int
+luhn_sum_avx2(const char *str, size_t len, unsigned int dbl)
+{
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i tbl = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const void*)luhn_dbl));
+	const __m256i msk = _mm256_set1_epi16(
+		dbl & 0b1U ? (short)0xff00 : 0x00ff);
+	__m256i wacc = _mm256_setzero_si256();
+	__m128i acc;
+	size_t i;
+
+	for (i = len; i >= 32U; i -= 32U) {
+		__m256i d = _mm256_loadu_si256((const void*)(str + i - 32U));
+
+		d = _mm256_sub_epi8(d, _mm256_set1_epi8('0'));
+		if (UNLIKELY(_mm256_movemask_epi8(
+				     _mm256_cmpeq_epi8(_mm256_max_epu8(d, nine),
+						       nine)) != -1)) {
+			return -1;
+		}
+		d = _mm256_blendv_epi8(d, _mm256_shuffle_epi8(tbl, d), msk);
+		wacc = _mm256_add_epi64(
+			wacc, _mm256_sad_epu8(d, _mm256_setzero_si256()));
+	}
+	acc = _mm_add_epi64(_mm256_castsi256_si128(wacc),
+			    _mm256_extracti128_si256(wacc, 1));
+	if (i >= 16U) {
+		const __m128i d = _mm_loadu_si128((const void*)(str + i - 16U));
+
+		if (UNLIKELY(luhn_blk_sse(
+				     &acc, d, _mm256_castsi256_si128(msk)) < 0)) {
+			return -1;
+		}
+		i -= 16U;
+	}
+	if (i && UNLIKELY(luhn_tail_sse(
+				  &acc, str, i, len,
+				  _mm256_castsi256_si128(msk)) < 0)) {
+		return -1;
+	}
+	return _mm_cvtsi128_si32(acc) + _mm_extract_epi32(acc, 2);
 }
 
-void
-nmpr_luhn(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+static int luhn_sum_rslv(const char*, size_t, unsigned int);
+static int(*luhn_sum_f)(const char*, size_t, unsigned int) = luhn_sum_rslv;
+
+static int
+luhn_sum_rslv(const char *str, size_t len, unsigned int dbl)
+{
+/* pick the best kernel for this cpu, racing threads will agree */
+	int(*f)(const char*, size_t, unsigned int) = luhn_sum_gen;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		f = luhn_sum_avx2;
+	} else if (__builtin_cpu_supports("sse4.1")) {
+		f = luhn_sum_sse;
+	}
+	__atomic_store_n(&luhn_sum_f, f, __ATOMIC_RELAXED);
+	return f(str, len, dbl);
+}
+
+int
+luhn_sum(const char *str, size_t len, unsigned int dbl)
+{
+	return __atomic_load_n(&luhn_sum_f, __ATOMIC_RELAXED)(str, len, dbl);
+}
+
+#elif defined LUHN_NEON
+int
+luhn_sum(const char *str, size_t len, unsigned int dbl)
+{
+/* same scheme as the x86 kernels, see there */
+	static const uint16_t m[2U] = {0x00ffU, 0xff00U};
+	const uint8x16_t tbl = vld1q_u8(luhn_dbl);
+	const uint8x16_t msk = vreinterpretq_u8_u16(vdupq_n_u16(m[dbl & 0b1U]));
+	uint_fast32_t sum = 0U;
+
+	for (size_t i = len; i > 0U;) {
+		uint8_t pad[16U];
+		uint8x16_t d;
+
+		if (LIKELY(i >= sizeof(pad))) {
+			i -= sizeof(pad);
+			d = vld1q_u8((const uint8_t*)str + i);
+		} else {
+			memset(pad, '0', sizeof(pad) - i);
+			memcpy(pad + sizeof(pad) - i, str, i);
+			d = vld1q_u8(pad);
+			i = 0U;
+		}
+		d = vsubq_u8(d, vdupq_n_u8('0'));
+		if (UNLIKELY(vmaxvq_u8(d) >= 10U)) {
+			return -1;
+		}
+		d = vbslq_u8(msk, vqtbl1q_u8(tbl, d), d);
+		sum += vaddlvq_u8(d);
+	}
+	return (int)sum;
+}
+
+#else  /* !LUHN_X86 && !LUHN_NEON */
+int
+luhn_sum(const char *str, size_t len, unsigned int dbl)
+{
+	return luhn_sum_gen(str, len, dbl);
+}
+#endif	/* LUHN_X86 || LUHN_NEON */
+
+
+nmck_t
+nmck_luhn(const char *str, size_t len)
+{
+	int sum;
+
+	if (len < 2U) {
+		/* no need to check single digits, nor no digits */
+		return -1;
+	} else if ((sum = luhn_sum(str, len, 0U)) < 0) {
+		return -1;
+	}
+	return !(sum % 10) - 1;
+}
+
+nmck_t
+nmdg_luhn(const struct nmdg_s *dg,
+	  const char *UNUSED(str), size_t UNUSED(len))
 {
+/* the last digit as is, the payload's last digit doubled */
+	const unsigned int sum = dg->d[dg->n - 1U] + dg->l[0U] + dg->s[1U];
+
+	return !(sum % 10U) - 1;
+}
+
+size_t
+nmfmt_luhn(char *restrict buf, nmck_t s,
+	   const char *UNUSED(str), size_t UNUSED(len))
+{
+	char *bp = buf;
+
 	if (!s) {
-		fputs("Luhn secured number, check passed", stdout);
+		bp = fmt_lit(bp, "Luhn secured number, check passed");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_luhn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_luhn, s, str, len);
 	return;
 }
 
+
+/* incremental, S[0] is the sum with the last digit as is and S[1] the
+ * sum with the last digit doubled, appending a digit swaps roles */
+int
+luhn_feed(struct nmck_state *st, char c)
+{
+	const unsigned int d = (unsigned char)(c ^ '0');
+	const unsigned int s0 = st->s[0U];
+
+	if (UNLIKELY(d >= 10U)) {
+		return -1;
+	}
+	st->s[0U] = (st->s[1U] + d) % 10U;
+	st->s[1U] = (s0 + luhn_dbl[d]) % 10U;
+	return 0;
+}
+
+int
+luhn_final(const struct nmck_state *st)
+{
+	if (st->len < 2U) {
+		return -1;
+	}
+	return st->s[0U] != 0U;
+}
+
 /* luhn.c ends here */
@@ -0,0 +1,180 @@
+/*** memo.c -- bounded cache of formatted results
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "memo.h"
+#include "hash.h"
+#include "nifty.h"
+
+/* size of one entry, key and output have to fit in */
+#define ENTZ	256U
+
+struct ent_s {
+	uint64_t h;
+	uint16_t klen;
+	uint16_t olen;
+	/* CLOCK reference bit */
+	uint8_t ref;
+	char dat[ENTZ - 13U];
+};
+
+struct memo_s {
+	struct ent_s *ent;
+	size_t nent;
+	size_t nuse;
+	/* CLOCK hand */
+	size_t hand;
+	/* open-addressing index, entry number + 1 or 0 for empty slots */
+	uint32_t *idx;
+	size_t imsk;
+};
+
+
+static void
+idx_del(struct memo_s *m, size_t i)
+{
+/* delete slot I, shifting back later members of its cluster */
+	for (size_t j = i; m->idx[j = (j + 1U) & m->imsk];) {
+		const size_t home = m->ent[m->idx[j] - 1U].h & m->imsk;
+
+		if (((j - home) & m->imsk) >= ((j - i) & m->imsk)) {
+			m->idx[i] = m->idx[j];
+			i = j;
+		}
+	}
+	m->idx[i] = 0U;
+	return;
+}
+
+
+struct memo_s*
+memo_make(size_t cap)
+{
+	/* the index takes 2 to 4 slots per entry */
+	const size_t nent = cap / (sizeof(struct ent_s) + 4U * sizeof(uint32_t));
+	struct memo_s *m;
+	size_t nidx;
+
+	if (nent < 16U || nent >= UINT32_MAX / 4U) {
+		return NULL;
+	} else if (UNLIKELY((m = calloc(1U, sizeof(*m))) == NULL)) {
+		return NULL;
+	}
+	for (nidx = 32U; nidx < 2U * nent; nidx *= 2U);
+	m->ent = malloc(nent * sizeof(*m->ent));
+	m->idx = calloc(nidx, sizeof(*m->idx));
+	if (UNLIKELY(m->ent == NULL || m->idx == NULL)) {
+		memo_free(m);
+		return NULL;
+	}
+	m->nent = nent;
+	m->imsk = nidx - 1U;
+	return m;
+}
+
+void
+memo_free(struct memo_s *m)
+{
+	if (m == NULL) {
+		return;
+	}
+	free(m->ent);
+	free(m->idx);
+	free(m);
+	return;
+}
+
+const char*
+memo_get(struct memo_s *m, const char *key, size_t klen, size_t *olen)
+{
+	const uint64_t h = hash64(key, klen, 0U);
+
+	for (size_t i = h & m->imsk; m->idx[i]; i = (i + 1U) & m->imsk) {
+		struct ent_s *e = m->ent + m->idx[i] - 1U;
+
+		if (e->h == h && e->klen == klen &&
+		    !memcmp(e->dat, key, klen)) {
+			e->ref = 1U;
+			*olen = e->olen;
+			return e->dat + klen;
+		}
+	}
+	return NULL;
+}
+
+void
+memo_put(struct memo_s *m, const char *key, size_t klen,
+	 const char *out, size_t olen)
+{
+	const uint64_t h = hash64(key, klen, 0U);
+	struct ent_s *e;
+	size_t k;
+
+	if (klen + olen > sizeof(e->dat)) {
+		return;
+	} else if (m->nuse < m->nent) {
+		k = m->nuse++;
+	} else {
+		/* evict the first entry not referenced since the last sweep */
+		for (; m->ent[m->hand].ref; m->hand = (m->hand + 1U) % m->nent) {
+			m->ent[m->hand].ref = 0U;
+		}
+		k = m->hand;
+		m->hand = (m->hand + 1U) % m->nent;
+		for (size_t i = m->ent[k].h & m->imsk;; i = (i + 1U) & m->imsk) {
+			if (m->idx[i] == k + 1U) {
+				idx_del(m, i);
+				break;
+			}
+		}
+	}
+	e = m->ent + k;
+	e->h = h;
+	e->klen = (uint16_t)klen;
+	e->olen = (uint16_t)olen;
+	e->ref = 0U;
+	memcpy(e->dat, key, klen);
+	memcpy(e->dat + klen, out, olen);
+	with (size_t i = h & m->imsk) {
+		for (; m->idx[i]; i = (i + 1U) & m->imsk);
+		m->idx[i] = (uint32_t)(k + 1U);
+	}
+	return;
+}
+
+/* memo.c ends here */
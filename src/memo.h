@@ -0,0 +1,70 @@
+/*** memo.h -- bounded cache of formatted results
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_memo_h_
+#define INCLUDED_memo_h_
+
+#include <stddef.h>
+
+/**
+ * Cache of the output produced for an input, keyed by the input bytes.
+ * Lookups and insertions are O(1), the cache never grows beyond the
+ * memory cap given at creation, once full the least recently used
+ * entries (approximately, CLOCK) make room for new ones.
+ * A cache must not be shared between threads. */
+struct memo_s;
+
+/**
+ * Make a cache that takes at most CAP bytes of memory, or NULL if CAP
+ * is too small or memory is short. */
+extern struct memo_s *memo_make(size_t cap);
+
+extern void memo_free(struct memo_s*);
+
+/**
+ * Return the cached output for input KEY of KLEN bytes, its length goes
+ * into *OLEN, or return NULL if KEY is not cached. */
+extern const char *memo_get(
+	struct memo_s*, const char *key, size_t klen, size_t *olen);
+
+/**
+ * Cache output OUT of OLEN bytes for input KEY of KLEN bytes, entries
+ * too large are silently ignored. */
+extern void memo_put(
+	struct memo_s*, const char *key, size_t klen,
+	const char *out, size_t olen);
+
+#endif	/* INCLUDED_memo_h_ */
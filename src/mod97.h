@@ -0,0 +1,94 @@
+/*** mod97.h -- shared MOD 97-10 engine
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_mod97_h_
+#define INCLUDED_mod97_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nifty.h"
+
+/* ISO 7064 MOD 97-10 as used by IBAN, LEI and RF creditor references.
+ * Letters count as two decimal digits (A = 10 ... Z = 35), so instead
+ * of expanding the string into a digit buffer we multiply the running
+ * remainder by 10 or 100 per character (Horner's scheme).  With 64 bits
+ * a remainder below 97 survives 8 such steps, so we reduce every 8th
+ * character only. */
+
+static inline __attribute__((const)) unsigned int
+mod97_val(char c)
+{
+/* value of C, 0-9 for digits, 10-35 for letters, 36 otherwise */
+	if ((unsigned char)(c ^ '0') < 10U) {
+		return (unsigned char)(c ^ '0');
+	} else if ((unsigned char)(c - 'A') < 26U) {
+		return (unsigned char)(c - 'A') + 10U;
+	}
+	return 36U;
+}
+
+/**
+ * Fold the characters of STR of length LEN into remainder R, skip those
+ * equal to SKIP, use -1 to skip nothing.
+ * Return the new remainder or -1 if STR has characters other than
+ * digits, upper case letters or SKIP.  If N is non-NULL, store the
+ * number of characters folded there. */
+static inline int
+mod97_fold(unsigned int r, const char *str, size_t len, int skip, size_t *n)
+{
+	uint_fast64_t acc = r;
+	size_t k = 0U;
+
+	for (size_t i = 0U; i < len; i++) {
+		const unsigned int v = mod97_val(str[i]);
+
+		if ((unsigned char)str[i] == skip) {
+			continue;
+		} else if (UNLIKELY(v >= 36U)) {
+			return -1;
+		}
+		acc = acc * (v < 10U ? 10U : 100U) + v;
+		if (!(++k % 8U)) {
+			acc %= 97U;
+		}
+	}
+	if (n != NULL) {
+		*n = k;
+	}
+	return (int)(acc % 97U);
+}
+
+#endif	/* INCLUDED_mod97_h_ */
@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -87,18 +88,27 @@ nmck_nhi(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_nhi(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_nhi(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("NHI, conformant", stdout);
+		bp = fmt_lit(bp, "NHI, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("NHI, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "NHI, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_nhi(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_nhi, s, str, len);
 	return;
 }
 
@@ -40,13 +40,15 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
 	machine numchk;
 
-	nhs = digit{9} (digit | check) %{c(nhs)} ;
+	nhs = digit{9} (digit | check) %{cd(nhs)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -77,18 +79,43 @@ nmck_nhs(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_nhs(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_nhs(const struct nmdg_s *dg, const char *str, size_t len)
 {
+	uint_fast32_t sum = dg->w;
+
+	if (UNLIKELY(len < 10U || len > 10U)) {
+		return -1;
+	} else if ((sum %= 11U) == 10U) {
+		/* number wouldn't be used */
+		return -1;
+	}
+	sum ^= '0';
+
+	return sum << 1U ^ ((char)sum != str[len - 1U]);
+}
+
+size_t
+nmfmt_nhs(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("NHS patient number, conformant", stdout);
+		bp = fmt_lit(bp, "NHS patient number, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("NHS patient number, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "NHS patient number, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_nhs(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_nhs, s, str, len);
 	return;
 }
 
@@ -40,13 +40,16 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "luhn.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
 	machine numchk;
 
-	npi = digit{9} (digit | check) %{c(npi)} ;
+	npi = digit{9} (digit | check) %{cd(npi)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -56,44 +59,58 @@ nmck_npi(const char *str, size_t len)
 {
 /* Luhn, started with 80840 */
 	uint_fast32_t sum = 4U;
-	uint_fast32_t w = 2U;
+	int x;
 
 	if (UNLIKELY(len < 10U || len > 10U)) {
 		return -1;
+	} else if (UNLIKELY((x = luhn_sum(str, len - 1U, 1U)) < 0)) {
+		return -1;
 	}
+	sum += (uint_fast32_t)x;
+	sum %= 10U;
+	sum = 10 - sum;
+	sum %= 10U;
+	sum ^= '0';
 
-	for (size_t i = 0U; i < len - 1U; i++) {
-		uint_fast32_t c = (unsigned char)(str[i] ^ '0');
+	return sum << 1U ^ ((char)sum != str[len - 1U]);
+}
 
-		if (UNLIKELY(c >= 10U)) {
-			return -1;
-		}
-		with (uint_fast32_t x = c * w) {
-			sum += x;
-			sum += (x >= 10U);
-		}
-		w ^= 3U;
+nmck_t
+nmdg_npi(const struct nmdg_s *dg, const char *str, size_t len)
+{
+	uint_fast32_t sum = 4U + dg->l[0U] + dg->s[1U];
+
+	if (UNLIKELY(len < 10U || len > 10U)) {
+		return -1;
 	}
 	sum %= 10U;
 	sum = 10 - sum;
 	sum %= 10U;
 	sum ^= '0';
-
 	return sum << 1U ^ ((char)sum != str[len - 1U]);
 }
 
-void
-nmpr_npi(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_npi(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("NPI, conformant", stdout);
+		bp = fmt_lit(bp, "NPI, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("NPI, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "NPI, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_npi(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_npi, s, str, len);
 	return;
 }
 
@@ -0,0 +1,84 @@
+/*** numchk-bin.h -- layout of numchk --binary output
+ *
+ * Copyright (C) 2014-2026 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_numchk_bin_h_
+#define INCLUDED_numchk_bin_h_
+
+#include <stdint.h>
+
+/**
+ * `numchk --binary' writes a header, a table of type names and then
+ * one fixed-size record per input, everything in host byte order.
+ *
+ * The type-name table holds NTYPES NUL-terminated names, the name of
+ * type id I being the I-th one, id 0 is `unknown'.  The table is padded
+ * with NULs so that the records start at offset HDRZ which is always a
+ * multiple of 8.  Consumers can mmap the file and treat everything past
+ * HDRZ as an array of struct nmck_bin_rec_s. */
+#define NMCK_BIN_MAGIC	"NMCK"
+#define NMCK_BIN_VERSION	2U
+#define NMCK_BIN_BOM	0xfeffU
+
+struct nmck_bin_hdr_s {
+	char magic[4U];
+	uint16_t vers;
+	/** NMCK_BIN_BOM, reads 0xfffe if the byte order doesn't match */
+	uint16_t bom;
+	/** size of one record */
+	uint16_t recz;
+	/** number of names in the type table */
+	uint16_t ntypes;
+	/** size of this header plus the type table, i.e. offset of record 0 */
+	uint32_t hdrz;
+};
+
+struct nmck_bin_rec_s {
+	/** byte offset of the input in the input stream,
+	 * command-line arguments count as newline-terminated lines */
+	uint64_t off;
+	/** length of the input, without line terminators */
+	uint32_t len;
+	/** type id, index into the type table */
+	uint16_t type;
+	/** 0 for conformant input, 1 for non-conformant input */
+	uint8_t status;
+	/** 1 for conclusive results, 0 for mere candidates */
+	uint8_t sure;
+	/** raw checker state, see nmck_t in numchk.h */
+	int64_t state;
+};
+
+#endif	/* INCLUDED_numchk_bin_h_ */
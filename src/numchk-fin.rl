@@ -0,0 +1,49 @@
+#include <string.h>
+#include <stdio.h>
+#include "dispatch.h"
+
+/* dispatcher for financial instruments, accounts and payments only */
+%%{
+	machine numchk_fin;
+
+	include numchk "dispatch.h";
+	include numchk "bic.c";
+	include numchk "credref.c";
+	include numchk "cusip.c";
+	include numchk "figi.c";
+	include numchk "iban.c";
+	include numchk "isin.c";
+	include numchk "lei.c";
+	include numchk "sedol.c";
+	include numchk "wkn.c";
+
+	main :=
+		iban |
+		figi |
+		isin |
+		cusip |
+		sedol |
+		lei |
+		bic |
+		wkn |
+		credref |
+
+		any*;
+
+	write data;
+}%%
+
+static int
+chck1_fin(struct chck_s *restrict ctx, const char *str, size_t len)
+{
+	const char *p = str;
+	const char *const pe = str + len;
+	const char *const eof = pe;
+	int cs;
+
+	%% write init;
+	ctx->ncand = ctx->nsure = 0U;
+
+	%% write exec;
+	return 0;
+}
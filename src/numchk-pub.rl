@@ -0,0 +1,46 @@
+#include <string.h>
+#include <stdio.h>
+#include "dispatch.h"
+
+/* dispatcher for publishing and media only */
+%%{
+	machine numchk_pub;
+
+	include numchk "dispatch.h";
+	include numchk "isan.c";
+	include numchk "isbn.c";
+	include numchk "ismn.c";
+	include numchk "isni.c";
+	include numchk "issn.c";
+	include numchk "istc.c";
+
+	main :=
+		isbn |
+		issn |
+		ismn |
+		isni |
+		istc |
+		isan |
+
+		any*;
+
+	write data;
+}%%
+
+static int
+chck1_pub(struct chck_s *restrict ctx, const char *str, size_t len)
+{
+	const char *p = str;
+	const char *const pe = str + len;
+	const char *const eof = pe;
+	struct nmdg_s dg[1U];
+	int cs;
+
+	%% write init;
+	ctx->ncand = ctx->nsure = 0U;
+	/* convert and sum up all-digit input once for all digit checkers */
+	nmdg_scan(dg, str, len);
+
+	%% write exec;
+	return 0;
+}
@@ -0,0 +1,126 @@
+#include <string.h>
+
+/* free-text scanner, tokens are classified as a whole by scan_tok() so
+ * the checkers' own actions are not needed */
+#define c(x)
+#define g(x)
+#define cd(x)
+#define gd(x)
+
+%%{
+	machine numchk_scan;
+
+	include numchk "dispatch.h";
+	include numchk "aadhaar.c";
+	include numchk "abartn.c";
+	include numchk "bic.c";
+	include numchk "bicc.c";
+	include numchk "cas.c";
+	include numchk "cpf.c";
+	include numchk "credcard.c";
+	include numchk "cusip.c";
+	include numchk "euvatid.c";
+	include numchk "figi.c";
+	include numchk "grid.c";
+	include numchk "gtin.c";
+	include numchk "iban.c";
+	include numchk "credref.c";
+	include numchk "idnr.c";
+	include numchk "imei.c";
+	include numchk "imo.c";
+	include numchk "iposan.c";
+	include numchk "isan.c";
+	include numchk "isbn.c";
+	include numchk "isin.c";
+	include numchk "ismn.c";
+	include numchk "isni.c";
+	include numchk "issn.c";
+	include numchk "istc.c";
+	include numchk "kennitala.c";
+	include numchk "lei.c";
+	include numchk "nhi.c";
+	include numchk "nhs.c";
+	include numchk "npi.c";
+	include numchk "oib.c";
+	include numchk "ppsn.c";
+	include numchk "sedol.c";
+	include numchk "tckimlik.c";
+	include numchk "tfn.c";
+	include numchk "titulo-eleitoral.c";
+	include numchk "upn.c";
+	include numchk "vin.c";
+	include numchk "wkn.c";
+
+	## identifiers start and end in letters or digits
+	id = (
+		iban |
+		figi |
+		isin |
+		istc |
+		cusip |
+		sedol |
+		lei |
+		gtin |
+		isbn |
+		issn |
+		ismn |
+		credcard |
+		credref |
+		tfn |
+		cas |
+		isni |
+		isan |
+		imo |
+		vin |
+		grid |
+		euvatid |
+		bicc |
+		bic |
+		wkn |
+		imei |
+		kennitala |
+		tckimlik |
+		aadhaar |
+		titulo_eleitoral |
+		cpf |
+		iposan |
+		npi |
+		abartn |
+		nhi |
+		ppsn |
+		idnr |
+		oib |
+		nhs |
+		upn
+	) & (alnum | alnum any* alnum);
+
+	main := |*
+		id => {fexec ts + scan_tok(o, str, ts, te - ts);};
+		## never start in the middle of a word
+		alnum+;
+		any;
+	*|;
+
+	write data;
+}%%
+
+#undef c
+#undef g
+#undef cd
+#undef gd
+
+static void
+scan1(struct obuf_s *o, const char *str, size_t len)
+{
+	const char *p = str;
+	const char *const pe = str + len;
+	const char *const eof = pe;
+	const char *ts, *te;
+	int cs, act;
+
+	%% write init;
+	(void)act;
+
+	%% write exec;
+	return;
+}
@@ -0,0 +1,50 @@
+#include <string.h>
+#include <stdio.h>
+#include "dispatch.h"
+
+/* dispatcher for tax and personal identification numbers only */
+%%{
+	machine numchk_tax;
+
+	include numchk "dispatch.h";
+	include numchk "cpf.c";
+	include numchk "euvatid.c";
+	include numchk "idnr.c";
+	include numchk "kennitala.c";
+	include numchk "oib.c";
+	include numchk "ppsn.c";
+	include numchk "tckimlik.c";
+	include numchk "tfn.c";
+
+	main :=
+		euvatid |
+		idnr |
+		cpf |
+		tfn |
+		tckimlik |
+		kennitala |
+		ppsn |
+		oib |
+
+		any*;
+
+	write data;
+}%%
+
+static int
+chck1_tax(struct chck_s *restrict ctx, const char *str, size_t len)
+{
+	const char *p = str;
+	const char *const pe = str + len;
+	const char *const eof = pe;
+	struct nmdg_s dg[1U];
+	int cs;
+
+	%% write init;
+	ctx->ncand = ctx->nsure = 0U;
+	/* convert and sum up all-digit input once for all digit checkers */
+	nmdg_scan(dg, str, len);
+
+	%% write exec;
+	return 0;
+}
@@ -45,10 +45,72 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "numchk.h"
+#include "numchk-bin.h"
 #include "nifty.h"
+#include "fmt.h"
+#include "fld.h"
+#include "memo.h"
+#include "cache.h"
+#include "hash.h"
+#include "dcmp.h"
+
+/* read buffer size, will grow for overlong lines */
+#define RDBUF_SIZE	(4U << 20U)
+/* unit of work in --jobs mode */
+#define CHNK_SIZE	(1U << 20U)
+/* corrections per input with --suggest */
+#define NSUGG		256U
+/* longest start of a --range */
+#define RNGE_MAXLEN	64U
+/* output buffer size, we flush whenever this is exceeded */
+#define OBUF_SIZE	(4U << 20U)
 
 static unsigned int allp;
+static unsigned int njobs = 1U;
+/* checkers to consult in --only mode */
+static nmck_type_t only[NMCK_NTYPES];
+static size_t nonly;
+/* classifier to use otherwise */
+static nmck_mach_t mach = NMCK_MACH_FULL;
+/* field to check, counting from 1, or 0 for whole lines */
+static size_t fldn;
+static char fldd = '\t';
+/* rewrite lines with result columns, or put them in place of the field */
+static unsigned int fldt;
+static unsigned int fldr;
+/* find identifiers anywhere in the input */
+static unsigned int scanp;
+/* numbers to generate from every input with --range */
+static size_t rngn;
+/* memory cap for caches of recent results, and the main thread's one */
+static size_t memz;
+static struct memo_s *memo;
+/* persistent result cache */
+static struct cache_s *cache;
+/* filters, print only (numbers of) lines that pass */
+static enum {
+	FILT_NONE,
+	FILT_VALID,
+	FILT_INVALID,
+	FILT_TYPE,
+} filt;
+static unsigned char ftype[NMCK_NTYPES];
+static unsigned int ftypep;
+static unsigned int lnop;
+
+/* tallies for --stats, by type and conformance */
+struct stat_s {
+	size_t nin;
+	size_t nunk;
+	size_t n[NMCK_NTYPES][2U];
+};
+
+static struct stat_s tally;
 
 
 static __attribute__((format(printf, 1, 2))) void
@@ -66,60 +128,1362 @@ error(const char *fmt, ...)
 	return;
 }
 
-#include "numchk.rlc"
+/* formatters by type */
+static size_t(*const nmfmt[NMCK_NTYPES])(char*, nmck_t, const char*, size_t) = {
+#define NMCK_TYPE(x)	[NMCK_##x] = nmfmt_##x,
+	NMCK_TYPES(NMCK_TYPE)
+#undef NMCK_TYPE
+};
+
+/* classification of one line, conclusive results first */
+struct chck_s {
+	size_t nsure;
+	size_t nres;
+	struct nmck_result res[NMCK_NTYPES];
+};
+
+static inline void
+chck1(struct chck_s *restrict ctx, const char *str, size_t len)
+{
+	int nc = 0;
+
+	if (cache != NULL && (nc = cache_get(cache, str, len, ctx->res)) >= 0) {
+		ctx->nres = nc;
+	} else if (LIKELY(!nonly)) {
+		ctx->nres = nmck_classify_mach(mach, str, len, ctx->res);
+	} else {
+		ctx->nres = nmck_classify_only(
+			str, len, only, nonly, ctx->res);
+	}
+	if (cache != NULL && nc < 0) {
+		cache_put(cache, str, len, ctx->res, ctx->nres);
+	}
+	for (ctx->nsure = 0U;
+	     ctx->nsure < ctx->nres && ctx->res[ctx->nsure].sure;
+	     ctx->nsure++);
+	return;
+}
+
+/* output buffers, lines are formatted into these and written in bulk */
+struct obuf_s {
+	char *buf;
+	size_t bsz;
+	size_t bcap;
+	/* stream offset of the line being printed */
+	size_t ioff;
+	/* number of lines before it */
+	size_t lno;
+	/* tallies instead of output with --stats */
+	struct stat_s *stat;
+};
+
+static struct obuf_s obuf;
+
+static char*
+obuf_room(struct obuf_s *o, size_t need)
+{
+	if (UNLIKELY(o->bsz + need > o->bcap)) {
+		size_t nu = o->bcap * 2U ?: 2U * OBUF_SIZE;
+		char *tmp;
+
+		while (nu < o->bsz + need) {
+			nu *= 2U;
+		}
+		if (UNLIKELY((tmp = realloc(o->buf, nu)) == NULL)) {
+			error("\
+error: cannot allocate memory for output");
+			abort();
+		}
+		o->buf = tmp;
+		o->bcap = nu;
+	}
+	return o->buf + o->bsz;
+}
+
+static void
+obuf_flush(struct obuf_s *o)
+{
+	if (o->bsz) {
+		fwrite(o->buf, sizeof(*o->buf), o->bsz, stdout);
+	}
+	o->bsz = 0U;
+	return;
+}
+
+static void
+prnt1_1ln(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+	const struct nmck_result *r = ctx->res;
+	char *bp = obuf_room(o, (ctx->nres + 1U) * (2U * len + NMFMT_SLACK));
+
+	bp = fmt_mem(bp, str, len);
+	if (ctx->nres) {
+		for (size_t i = 0U; i < ctx->nsure; i++) {
+			*bp++ = '\t';
+			bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+		}
+		if (allp || !ctx->nsure) {
+			for (size_t i = ctx->nsure; i < ctx->nres; i++) {
+				*bp++ = '\t';
+				bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+			}
+		}
+		*bp++ = '\n';
+	} else {
+		bp = fmt_lit(bp, "\tunknown\n");
+	}
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_mln(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+	const struct nmck_result *r = ctx->res;
+	char *bp = obuf_room(o, (ctx->nres + 1U) * (2U * len + NMFMT_SLACK));
+
+	if (ctx->nres) {
+		for (size_t i = 0U; i < ctx->nsure; i++) {
+			bp = fmt_mem(bp, str, len);
+			*bp++ = '\t';
+			bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+			*bp++ = '\n';
+		}
+		if (allp || !ctx->nsure) {
+			for (size_t i = ctx->nsure; i < ctx->nres; i++) {
+				bp = fmt_mem(bp, str, len);
+				*bp++ = '\t';
+				bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+				*bp++ = '\n';
+			}
+		}
+	} else {
+		bp = fmt_mem(bp, str, len);
+		bp = fmt_lit(bp, "\tunknown\n");
+	}
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_fix(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+/* print STR with the check characters of the first suggestion patched
+ * in, unless there's a conformant result */
+	const struct nmck_result *r = ctx->res;
+	const struct nmck_result *fix = NULL;
+	char *bp = obuf_room(o, len + 1U);
+
+	for (size_t i = 0U; i < ctx->nres; i++) {
+		if (!r[i].status) {
+			fix = NULL;
+			break;
+		} else if (fix == NULL && r[i].nchk) {
+			fix = r + i;
+		}
+	}
+	memcpy(bp, str, len);
+	if (fix != NULL) {
+		for (size_t j = 0U; j < fix->nchk; j++) {
+			bp[fix->off[j]] = fix->chk[j];
+		}
+	}
+	bp += len;
+	*bp++ = '\n';
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_cmpl(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+/* print STR with its placeholders filled in where possible */
+	const struct nmck_result *r = nmck_completion(ctx->res, ctx->nres, str, len);
+	char *bp = obuf_room(o, len + 1U);
+
+	memcpy(bp, str, len);
+	if (r != NULL) {
+		for (size_t j = 0U; j < r->nchk; j++) {
+			bp[r->off[j]] = r->chk[j];
+		}
+	}
+	bp += len;
+	*bp++ = '\n';
+	o->bsz = bp - o->buf;
+	return;
+}
 
 static void
-prnt1_1ln(const char *str, size_t len)
+prnt1_sugg(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
 {
-	fputs(str, stdout);
-	if (ncand || nsure) {
-		for (size_t i = 0U; i < nsure; i++) {
-			fputc('\t', stdout);
-			surepr[i](sureck[i], str, len);
+/* print corrections of STR for the types it failed, best ones first */
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp || !ctx->nsure ? ctx->nres : ctx->nsure;
+	struct nmck_sugg sg[NSUGG];
+	size_t ns = 0U;
+	char *bp;
+
+	for (size_t i = 0U; i < nr && ns < countof(sg); i++) {
+		if (r[i].status) {
+			size_t n = nmck_suggest(
+				r[i].type, str, len, sg + ns, countof(sg) - ns);
+			ns += n < countof(sg) - ns ? n : countof(sg) - ns;
 		}
-		if (allp || !nsure) {
-			for (size_t i = 0U; i < ncand; i++) {
-				fputc('\t', stdout);
-				candpr[i](candck[i], str, len);
+	}
+	bp = obuf_room(o, ns * (2U * len + 32U));
+	for (unsigned int k = 0U; k < 4U; k++) {
+		for (size_t i = 0U; i < ns; i++) {
+			if (sg[i].rank != k) {
+				continue;
+			}
+			bp = fmt_mem(bp, str, len);
+			*bp++ = '\t';
+			memcpy(bp, str, len);
+			bp[sg[i].off] = sg[i].chr[0U];
+			if (sg[i].rank == 1U) {
+				bp[sg[i].off + 1U] = sg[i].chr[1U];
 			}
+			bp += len;
+			*bp++ = '\t';
+			bp = fmt_str(bp, nmck_type_name(sg[i].type));
+			*bp++ = '\n';
+		}
+	}
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static char*
+jsn1(char *restrict bp, const struct nmck_result *r)
+{
+	const char *tn = nmck_type_name(r->type);
+
+	bp = fmt_lit(bp, "{\"type\":\"");
+	bp = fmt_str(bp, tn);
+	bp = fmt_lit(bp, "\",\"conformant\":");
+	bp = r->status ? fmt_lit(bp, "false") : fmt_lit(bp, "true");
+	bp = fmt_lit(bp, ",\"sure\":");
+	bp = r->sure ? fmt_lit(bp, "true") : fmt_lit(bp, "false");
+	if (r->nchk) {
+		bp = fmt_lit(bp, ",\"check\":\"");
+		bp = fmt_jstr(bp, r->chk, r->nchk);
+		bp = fmt_lit(bp, "\",\"at\":[");
+		for (size_t j = 0U; j < r->nchk; j++) {
+			bp = fmt_u(bp, r->off[j]);
+			*bp++ = ',';
 		}
-		fputc('\n', stdout);
+		bp[-1] = ']';
+	}
+	*bp++ = '}';
+	return bp;
+}
+
+static void
+prnt1_json(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+	/* every result object takes < 128 bytes, the input at most 6 per char */
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp || !ctx->nsure ? ctx->nres : ctx->nsure;
+	char *bp = obuf_room(o, 6U * len + (nr + 1U) * 128U);
+
+	if (scanp) {
+		bp = fmt_lit(bp, "{\"offset\":");
+		bp = fmt_zu(bp, o->ioff);
+		bp = fmt_lit(bp, ",\"input\":\"");
 	} else {
-		fputs("\tunknown\n", stdout);
+		bp = fmt_lit(bp, "{\"input\":\"");
+	}
+	bp = fmt_jstr(bp, str, len);
+	bp = fmt_lit(bp, "\",\"results\":[");
+	for (size_t i = 0U; i < nr; i++) {
+		bp = jsn1(bp, r + i);
+		*bp++ = ',';
+	}
+	bp -= nr > 0U;
+	bp = fmt_lit(bp, "]}\n");
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_bin(struct obuf_s *o, const struct chck_s *ctx, const char *UNUSED(str), size_t len)
+{
+	/* one record per input, or per result with --all */
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp ? ctx->nres : ctx->nres > 0U;
+	struct nmck_bin_rec_s *rp;
+	char *bp = obuf_room(o, (nr ?: 1U) * sizeof(*rp));
+
+	rp = (void*)bp;
+	for (size_t i = 0U; i < nr; i++) {
+		rp[i] = (struct nmck_bin_rec_s){
+			.off = o->ioff,
+			.len = (uint32_t)len,
+			.type = (uint16_t)r[i].type,
+			.status = r[i].status,
+			.sure = r[i].sure,
+			.state = r[i].state,
+		};
 	}
+	if (!nr) {
+		rp[0U] = (struct nmck_bin_rec_s){
+			.off = o->ioff,
+			.len = (uint32_t)len,
+			.type = NMCK_UNK,
+		};
+	}
+	o->bsz = (char*)(rp + (nr ?: 1U)) - o->buf;
 	return;
 }
 
 static void
-prnt1_mln(const char *str, size_t len)
+prnt_bin_hdr(struct obuf_s *o)
+{
+	struct nmck_bin_hdr_s h = {
+		.magic = NMCK_BIN_MAGIC,
+		.vers = NMCK_BIN_VERSION,
+		.bom = NMCK_BIN_BOM,
+		.recz = sizeof(struct nmck_bin_rec_s),
+		.ntypes = NMCK_NTYPES,
+	};
+	char *bp = obuf_room(o, sizeof(h) + NMCK_NTYPES * 32U + 8U);
+	char *tp = bp + sizeof(h);
+
+	for (nmck_type_t t = NMCK_UNK; t < NMCK_NTYPES; t++) {
+		tp = fmt_str(tp, nmck_type_name(t));
+		*tp++ = '\0';
+	}
+	while ((tp - bp) % 8U) {
+		*tp++ = '\0';
+	}
+	h.hdrz = (uint32_t)(tp - bp);
+	memcpy(bp, &h, sizeof(h));
+	o->bsz += tp - bp;
+	return;
+}
+
+static void(*prnt1)(struct obuf_s*, const struct chck_s*, const char*, size_t);
+
+static inline int
+filt1(const struct chck_s *ctx)
+{
+/* whether a line classified as CTX passes the filter */
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp || !ctx->nsure ? ctx->nres : ctx->nsure;
+	int valid = 0;
+
+	switch (filt) {
+	case FILT_VALID:
+	case FILT_INVALID:
+		for (size_t i = 0U; i < ctx->nsure; i++) {
+			valid |= !ftypep || ftype[r[i].type];
+		}
+		return valid ^ (filt == FILT_INVALID);
+	case FILT_TYPE:
+		for (size_t i = 0U; i < nr; i++) {
+			if (ftype[r[i].type]) {
+				return 1;
+			}
+		}
+		return 0;
+	default:
+		return 1;
+	}
+}
+
+static void
+prnt_ln(struct obuf_s *o, const char *ln, size_t lz)
 {
-	if (ncand || nsure) {
-		for (size_t i = 0U; i < nsure; i++) {
-			fputs(str, stdout);
-			fputc('\t', stdout);
-			surepr[i](sureck[i], str, len);
-			fputc('\n', stdout);
+/* filter output, the line itself or its number */
+	char *bp = obuf_room(o, lz + 24U);
+
+	bp = lnop ? fmt_zu(bp, o->lno + 1U) : fmt_mem(bp, ln, lz);
+	*bp++ = '\n';
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_stat(struct obuf_s *o, const struct chck_s *ctx, const char *UNUSED(str), size_t UNUSED(len))
+{
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp || !ctx->nsure ? ctx->nres : ctx->nsure;
+	struct stat_s *st = o->stat;
+
+	st->nin++;
+	st->nunk += !nr;
+	for (size_t i = 0U; i < nr; i++) {
+		st->n[r[i].type][r[i].status]++;
+	}
+	return;
+}
+
+static void
+prnt_stat(struct obuf_s *o, const struct stat_s *st, int jsonp)
+{
+	char *bp = obuf_room(o, (NMCK_NTYPES + 4U) * 128U);
+
+	if (jsonp) {
+		bp = fmt_lit(bp, "{\"inputs\":");
+		bp = fmt_zu(bp, st->nin);
+		bp = fmt_lit(bp, ",\"unknown\":");
+		bp = fmt_zu(bp, st->nunk);
+		bp = fmt_lit(bp, ",\"types\":{");
+	} else {
+		bp = fmt_lit(bp, "type\tconformant\tnonconformant\n");
+	}
+	for (nmck_type_t t = NMCK_UNK + 1U; t < NMCK_NTYPES; t++) {
+		if (!st->n[t][0U] && !st->n[t][1U]) {
+			continue;
+		} else if (jsonp) {
+			*bp++ = '"';
+			bp = fmt_str(bp, nmck_type_name(t));
+			bp = fmt_lit(bp, "\":{\"conformant\":");
+			bp = fmt_zu(bp, st->n[t][0U]);
+			bp = fmt_lit(bp, ",\"nonconformant\":");
+			bp = fmt_zu(bp, st->n[t][1U]);
+			bp = fmt_lit(bp, "},");
+		} else {
+			bp = fmt_str(bp, nmck_type_name(t));
+			*bp++ = '\t';
+			bp = fmt_zu(bp, st->n[t][0U]);
+			*bp++ = '\t';
+			bp = fmt_zu(bp, st->n[t][1U]);
+			*bp++ = '\n';
+		}
+	}
+	if (jsonp) {
+		bp -= bp[-1] == ',';
+		bp = fmt_lit(bp, "}}\n");
+	} else {
+		bp = fmt_lit(bp, "unknown\t");
+		bp = fmt_zu(bp, st->nunk);
+		bp = fmt_lit(bp, "\ntotal\t");
+		bp = fmt_zu(bp, st->nin);
+		*bp++ = '\n';
+	}
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_filt(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+	if (filt1(ctx)) {
+		prnt_ln(o, str, len);
+	}
+	return;
+}
+
+static char*
+fmt_col(char *restrict bp, const struct nmck_result *r, const char *str, size_t len)
+{
+/* format R as a column, quoted if it contains delimiters or quotes */
+	char *cp = bp + 1U;
+	const size_t n = nmfmt[r->type](cp, r->state, str, len);
+	size_t nq = 0U;
+
+	for (size_t i = 0U; i < n; i++) {
+		nq += cp[i] == '"';
+	}
+	if (!nq && memchr(cp, fldd, n) == NULL) {
+		memmove(bp, cp, n);
+		return bp + n;
+	}
+	/* expand from the back, doubling quotes */
+	bp[n + nq + 1U] = '"';
+	for (size_t i = n, o = n + nq; i-- > 0U;) {
+		const char c = cp[i];
+
+		bp[o--] = c;
+		if (c == '"') {
+			bp[o--] = '"';
+		}
+	}
+	bp[0U] = '"';
+	return bp + n + nq + 2U;
+}
+
+static void
+prnt1_fld(struct obuf_s *o, const struct chck_s *ctx,
+	  const char *ln, size_t lz, struct fld_s f, const char *str, size_t len)
+{
+/* line LN with result columns for STR, the contents of field F */
+	const struct nmck_result *r = ctx->res;
+	const size_t nr = allp || !ctx->nsure ? ctx->nres : ctx->nsure;
+	char *bp = obuf_room(
+		o, lz + 2U + (nr + 1U) * (2U * (2U * len + NMFMT_SLACK) + 3U));
+
+	if (fldr) {
+		bp = fmt_mem(bp, ln, f.off);
+		if (f.off && ln[f.off - 1U] != fldd) {
+			/* the field is missing */
+			*bp++ = fldd;
+		}
+	} else {
+		bp = fmt_mem(bp, ln, lz);
+		*bp++ = fldd;
+	}
+	for (size_t i = 0U; i < nr; i++) {
+		bp = fmt_col(bp, r + i, str, len);
+		*bp++ = fldd;
+	}
+	if (nr) {
+		bp--;
+	} else {
+		bp = fmt_lit(bp, "unknown");
+	}
+	if (fldr) {
+		bp = fmt_mem(bp, ln + f.off + f.len, lz - (f.off + f.len));
+	}
+	*bp++ = '\n';
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_scan(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+/* like prnt1_mln() but prefixed by the stream offset of STR */
+	const struct nmck_result *r = ctx->res;
+	char *bp = obuf_room(o, (ctx->nres + 1U) * (2U * len + NMFMT_SLACK + 24U));
+
+	for (size_t i = 0U; i < ctx->nres; i++) {
+		bp = fmt_zu(bp, o->ioff);
+		*bp++ = '\t';
+		bp = fmt_mem(bp, str, len);
+		*bp++ = '\t';
+		bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+		*bp++ = '\n';
+	}
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static void
+prnt1_scan1ln(struct obuf_s *o, const struct chck_s *ctx, const char *str, size_t len)
+{
+	const struct nmck_result *r = ctx->res;
+	char *bp = obuf_room(o, (ctx->nres + 1U) * (2U * len + NMFMT_SLACK) + 24U);
+
+	bp = fmt_zu(bp, o->ioff);
+	*bp++ = '\t';
+	bp = fmt_mem(bp, str, len);
+	for (size_t i = 0U; i < ctx->nres; i++) {
+		*bp++ = '\t';
+		bp += nmfmt[r[i].type](bp, r[i].state, str, len);
+	}
+	*bp++ = '\n';
+	o->bsz = bp - o->buf;
+	return;
+}
+
+static size_t
+scan_tok(struct obuf_s *o, const char *ln, const char *str, size_t len)
+{
+/* print the token STR found in line LN if it classifies, otherwise try
+ * its prefixes ending in a word, return the number of bytes consumed */
+	struct chck_s ctx[1U];
+	const char *sp;
+
+	for (size_t n = len;; n = sp - str) {
+		chck1(ctx, str, n);
+		if (!allp) {
+			/* candidates are mostly noise in free text */
+			ctx->nres = ctx->nsure;
+		}
+		if (ctx->nres) {
+			o->ioff += str - ln;
+			prnt1(o, ctx, str, n);
+			o->ioff -= str - ln;
+			return n;
+		}
+		for (sp = str + n; sp > str && sp[-1] != ' '; sp--);
+		if (sp == str) {
+			return n;
+		}
+		/* tokens start with a letter or digit, so this stops */
+		for (sp--; sp[-1] == ' '; sp--);
+	}
+}
+
+#include "numchk-scan.rlc"
+
+/* digit-based types whose check characters come last and can be had
+ * incrementally, INCP is 2 for generic checkers, which don't complete
+ * numbers, PRE is fed before the number proper, check characters are
+ * taken from CHKS, or else are digits */
+static const struct {
+	unsigned char incp;
+	nmck_algo_t algo;
+	const char *pre;
+	const char *chks;
+} rnge_algo[NMCK_NTYPES] = {
+	[NMCK_luhn] = {2U, NMCK_ALGO_LUHN},
+	[NMCK_credcard] = {1U, NMCK_ALGO_LUHN},
+	[NMCK_imei] = {1U, NMCK_ALGO_LUHN},
+	[NMCK_npi] = {1U, NMCK_ALGO_LUHN, "80840"},
+	[NMCK_gtin] = {1U, NMCK_ALGO_MOD10_31},
+	[NMCK_isbn13] = {1U, NMCK_ALGO_MOD10_31},
+	[NMCK_ismn13] = {1U, NMCK_ALGO_MOD10_31},
+	[NMCK_isbn10] = {1U, NMCK_ALGO_MOD11, NULL, "0123456789X"},
+	[NMCK_lei] = {1U, NMCK_ALGO_MOD97},
+	[NMCK_verhoeff] = {2U, NMCK_ALGO_VERHOEFF},
+	[NMCK_aadhaar] = {1U, NMCK_ALGO_VERHOEFF},
+	[NMCK_damm10] = {2U, NMCK_ALGO_DAMM10},
+	[NMCK_damm16] = {2U, NMCK_ALGO_DAMM16, NULL, "0123456789ABCDEF"},
+};
+
+static int
+rnge_chk(char *restrict chk, size_t k,
+	 const struct nmck_state *st, const char *chks)
+{
+/* find K check characters from CHKS that complete ST, put them in CHK,
+ * return 0 if there are such characters or -1 if not */
+	if (!k) {
+		return nmck_state_final(st) ? -1 : 0;
+	}
+	for (const char *c = chks; *c; c++) {
+		struct nmck_state x = *st;
+
+		if (nmck_state_feed(&x, *c) < 0) {
+			continue;
+		}
+		*chk = *c;
+		if (!rnge_chk(chk + 1U, k - 1U, &x, chks)) {
+			return 0;
+		}
+	}
+	return -1;
+}
+
+static ssize_t
+rnge_inc(char *str, size_t len, const unsigned char *chkp)
+{
+/* count up the digits of STR that aren't check characters, letters stay
+ * as they are and carries go past them, return the leftmost position
+ * changed or -1 if we ran out of digits */
+	for (size_t i = len; i-- > 0U;) {
+		if (chkp[i] || (unsigned char)(str[i] ^ '0') >= 10U) {
+			continue;
+		} else if (str[i] < '9') {
+			str[i]++;
+			return i;
+		}
+		str[i] = '0';
+	}
+	return -1;
+}
+
+static inline void
+rnge_out(struct obuf_s *o, const char *str, size_t len)
+{
+	char *bp = obuf_room(o, len + 1U);
+
+	memcpy(bp, str, len);
+	bp[len] = '\n';
+	o->bsz += len + 1U;
+	if (o->bsz >= OBUF_SIZE) {
+		/* --range runs single-threaded, so O goes straight out */
+		obuf_flush(o);
+	}
+	return;
+}
+
+static int
+rnge_okp(const char *str, size_t len, nmck_type_t t)
+{
+	struct nmck_result res[NMCK_NTYPES];
+
+	return nmck_classify_only(str, len, &t, 1U, res) && !res->status;
+}
+
+static void
+rnge1(struct obuf_s *o, const char *str, size_t len)
+{
+/* print RNGN conformant numbers counting up from STR, the type is that
+ * of STR with its placeholders, or else its last character, left out */
+	struct nmck_state st[RNGE_MAXLEN];
+	unsigned char chkp[RNGE_MAXLEN] = {0U};
+	char buf[RNGE_MAXLEN];
+	struct chck_s ctx[1U];
+	const struct nmck_result *r;
+	nmck_type_t t;
+	size_t n = 0U;
+	/* number of check characters at the end of STR */
+	size_t k = 1U;
+	ssize_t p;
+	/* -1 before the first number, then whether numbers are out of type */
+	int out = -1;
+	/* the last position counted up, i.e. the one that changes most */
+	size_t lp;
+
+	if (UNLIKELY(len < 2U || len > sizeof(buf))) {
+		goto nope;
+	}
+	memcpy(buf, str, len);
+	if (!memchr(buf, '_', len) && !memchr(buf, '?', len)) {
+		buf[len - 1U] = '_';
+	}
+	chck1(ctx, buf, len);
+	if ((r = nmck_completion(ctx->res, ctx->nres, buf, len)) != NULL) {
+		t = r->type;
+		for (size_t j = 0U; j < r->nchk; j++) {
+			chkp[r->off[j]] = 1U;
+		}
+		/* K stays 0 unless the check characters make up the tail */
+		for (k = 0U; k < r->nchk &&
+			     r->off[k] == len - r->nchk + k; k++);
+		k = k == r->nchk ? k : 0U;
+	} else if (nonly == 1U && rnge_algo[*only].incp > 1U &&
+		   (buf[len - 1U] == '_' || buf[len - 1U] == '?') &&
+		   !memchr(buf, '_', len - 1U) && !memchr(buf, '?', len - 1U)) {
+		/* generic checkers know only passing numbers and have
+		 * nothing to complete, leave the check digit to the
+		 * algorithm and see if the checker agrees */
+		t = *only;
+		chkp[len - 1U] = 1U;
+	} else {
+		goto nope;
+	}
+
+	if (rnge_algo[t].incp && k) {
+		/* ST[I] is the state after the first I characters, counting
+		 * up only changes the characters from P on, the check
+		 * characters are then found by trial on state ST[LEN - K] */
+		const char *chks = rnge_algo[t].chks ?: "0123456789";
+
+		for (lp = len; lp-- > 0U &&
+			     (chkp[lp] || (unsigned char)(buf[lp] ^ '0') >= 10U););
+		nmck_state_init(st, rnge_algo[t].algo);
+		for (const char *pp = rnge_algo[t].pre; pp && *pp; pp++) {
+			nmck_state_feed(st, *pp);
+		}
+		for (p = 0; n < rngn && p >= 0; p = rnge_inc(buf, len, chkp)) {
+			for (size_t i = p; i < len - k; i++) {
+				st[i + 1U] = st[i];
+				nmck_state_feed(st + i + 1U, buf[i]);
+			}
+			if (UNLIKELY(rnge_chk(buf + len - k, k,
+					      st + len - k, chks) < 0)) {
+				/* the algorithm has no check characters
+				 * for this one, skip it, or if it's STR
+				 * leave it to the checker */
+				if (out >= 0) {
+					continue;
+				} else if (r == NULL) {
+					goto nope;
+				}
+				break;
+			} else if (UNLIKELY(out < 0)) {
+				if (r == NULL && !rnge_okp(buf, len, t)) {
+					goto nope;
+				} else if (r && memcmp(buf + len - k, r->chk, k)) {
+					/* checker and algorithm disagree on
+					 * STR, e.g. for its length, go the
+					 * slow way */
+					break;
+				}
+				out = 0;
+			} else if ((size_t)p < lp) {
+				/* the digit counted up last decides
+				 * nothing but the check characters, so
+				 * only carries may take us in or out of
+				 * the type */
+				out = !rnge_okp(buf, len, t);
+			}
+			if (out) {
+				/* skip numbers that don't fit, like the
+				 * slow way, all of them up to the next
+				 * carry into P in one go */
+				for (size_t i = p + 1U; i < len; i++) {
+					if (!chkp[i] &&
+					    (unsigned char)(buf[i] ^ '0') < 10U) {
+						buf[i] = '9';
+					}
+				}
+				continue;
+			}
+			rnge_out(o, buf, len);
+			n++;
+		}
+		if (out >= 0) {
+			goto fin;
+		}
+	}
+
+	/* check characters from scratch for every number, numbers that
+	 * don't fit the type anymore are skipped */
+	for (p = 0; n < rngn && p >= 0; p = rnge_inc(buf, len, chkp)) {
+		struct nmck_result res[NMCK_NTYPES];
+		size_t nr;
+
+		for (size_t j = 0U; j < r->nchk; j++) {
+			buf[r->off[j]] = '_';
 		}
-		if (allp || !nsure) {
-			for (size_t i = 0U; i < ncand; i++) {
-				fputs(str, stdout);
-				fputc('\t', stdout);
-				candpr[i](candck[i], str, len);
-				fputc('\n', stdout);
+		nr = nmck_classify_only(buf, len, &t, 1U, res);
+		if (nmck_completion(res, nr, buf, len) != NULL) {
+			for (size_t j = 0U; j < res->nchk; j++) {
+				buf[res->off[j]] = res->chk[j];
 			}
+			rnge_out(o, buf, len);
+			n++;
+		}
+	}
+fin:
+	if (UNLIKELY(n < rngn)) {
+		errno = 0;
+		error("\
+warning: only %zu of %zu numbers counting up from `%.*s'",
+		      n, rngn, (int)len, str);
+	}
+	return;
+
+nope:
+	errno = 0;
+	error("error: cannot count up from `%.*s'", (int)len, str);
+	return;
+}
+
+static inline void
+line1(struct obuf_s *o, struct memo_s *m, const char *ln, size_t lz)
+{
+	struct chck_s ctx[1U];
+	struct fld_s f;
+	char tmp[256U];
+	const char *str;
+	size_t len;
+
+	if (rngn) {
+		rnge1(o, ln, lz);
+		return;
+	} else if (scanp) {
+		scan1(o, ln, lz);
+		return;
+	} else if (m != NULL) {
+		/* output depends on LN only, replay it if we've seen LN */
+		const size_t o0 = o->bsz;
+		const char *hit;
+		size_t hz;
+
+		if ((hit = memo_get(m, ln, lz, &hz)) != NULL) {
+			memcpy(obuf_room(o, hz), hit, hz);
+			o->bsz += hz;
+			return;
+		}
+		chck1(ctx, ln, lz);
+		prnt1(o, ctx, ln, lz);
+		memo_put(m, ln, lz, o->buf + o0, o->bsz - o0);
+		return;
+	} else if (!fldn) {
+		chck1(ctx, ln, lz);
+		prnt1(o, ctx, ln, lz);
+		return;
+	} else if (fld_find(&f, ln, lz, fldd, fldn - 1U) < 0) {
+		/* missing fields count as empty ones at the end */
+		f = (struct fld_s){lz, 0U};
+	}
+	len = f.len;
+	str = fld_str(tmp, sizeof(tmp), ln + f.off, &len);
+	chck1(ctx, str, len);
+	if (filt) {
+		if (filt1(ctx)) {
+			prnt_ln(o, ln, lz);
 		}
+	} else if (fldt) {
+		prnt1_fld(o, ctx, ln, lz, f, str, len);
 	} else {
-		fputs(str, stdout);
-		fputs("\tunknown\n", stdout);
+		o->ioff += f.off;
+		prnt1(o, ctx, str, len);
+		o->ioff -= f.off;
 	}
 	return;
 }
 
-static void(*prnt1)(const char*, size_t);
+static inline void
+proc1(const char *str, size_t len)
+{
+	const size_t raw = len;
+
+	/* strip dos line endings */
+	len -= len && str[len - 1U] == '\r';
+	line1(&obuf, memo, str, len);
+	obuf.ioff += raw + 1U;
+	obuf.lno++;
+	if (obuf.bsz >= OBUF_SIZE) {
+		obuf_flush(&obuf);
+	}
+	return;
+}
+
+static size_t
+proc_buf(const char *buf, size_t bsz)
+{
+/* process all complete lines in BUF and return the number of bytes used,
+ * lines are handed out in situ, memchr() does the vectorised scan */
+	const char *bp = buf;
+	const char *const ep = buf + bsz;
+
+	for (const char *eol;
+	     (eol = memchr(bp, '\n', ep - bp)) != NULL; bp = eol + 1U) {
+		proc1(bp, eol - bp);
+	}
+	return bp - buf;
+}
+
+static int
+proc_map(int fd)
+{
+	struct stat st;
+	off_t off;
+	size_t mz;
+	char *mp;
+
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+		return -1;
+	} else if ((off = lseek(fd, 0, SEEK_CUR)) < 0 || off >= st.st_size) {
+		return -1;
+	}
+	mz = st.st_size;
+	mp = mmap(NULL, mz, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (UNLIKELY(mp == MAP_FAILED)) {
+		return -1;
+	}
+	(void)posix_madvise(mp, mz, POSIX_MADV_SEQUENTIAL);
+
+	with (size_t n = off + proc_buf(mp + off, mz - off)) {
+		if (n < mz) {
+			/* unterminated last line, copy it so that checkers
+			 * never have to look past the mapping */
+			char *tl = malloc(mz - n + 1U);
+
+			if (LIKELY(tl != NULL)) {
+				memcpy(tl, mp + n, mz - n);
+				tl[mz - n] = '\0';
+				proc1(tl, mz - n);
+				free(tl);
+			}
+		}
+	}
+	munmap(mp, mz);
+	/* leave the file offset where getline() would have */
+	(void)lseek(fd, 0, SEEK_END);
+	return 0;
+}
+
+static int
+proc_fd(int fd)
+{
+	size_t bsz = 0U;
+	size_t bcap = RDBUF_SIZE;
+	struct dcmp_s *d;
+	char *buf;
+	ssize_t nrd;
+
+	if (UNLIKELY((d = dcmp_open(fd)) == NULL)) {
+		return -1;
+	} else if (dcmp_codec(d) == NULL && !proc_map(fd)) {
+		dcmp_close(d);
+		return 0;
+	} else if (UNLIKELY((buf = malloc(bcap)) == NULL)) {
+		dcmp_close(d);
+		return -1;
+	}
+	/* always keep one byte for the terminating NUL */
+	while ((nrd = dcmp_read(d, buf + bsz, bcap - bsz - 1U)) > 0) {
+		const size_t n = proc_buf(buf, bsz += nrd);
+
+		memmove(buf, buf + n, bsz -= n);
+		if (UNLIKELY(bsz + 1U >= bcap)) {
+			/* line longer than our buffer */
+			char *tmp = realloc(buf, bcap *= 2U);
+
+			if (UNLIKELY(tmp == NULL)) {
+				nrd = -1;
+				break;
+			}
+			buf = tmp;
+		}
+	}
+	if (bsz) {
+		buf[bsz] = '\0';
+		proc1(buf, bsz);
+	}
+	free(buf);
+	dcmp_close(d);
+	return nrd < 0 ? -1 : 0;
+}
+
+
+/* threaded mode, the reader (main thread) cuts the input into chunks,
+ * workers classify and format them and the writer prints them in
+ * input order */
+struct chnk_s {
+	const char *buf;
+	size_t bsz;
+	/* stream offset of BUF and number of lines before it */
+	size_t ioff;
+	size_t lno;
+	/* own storage, unless BUF points into a mapping */
+	char *own;
+	size_t ocap;
+	/* formatted output */
+	struct obuf_s out;
+	enum {
+		CHNK_FREE,
+		CHNK_FULL,
+		CHNK_DONE,
+	} st;
+};
+
+static struct {
+	pthread_mutex_t mtx;
+	pthread_cond_t cnd;
+	struct chnk_s *q;
+	size_t nq;
+	/* sequence numbers of chunks filled, classified and printed */
+	size_t nfil;
+	size_t nchk;
+	size_t nprt;
+	int eof;
+	/* input mapping, if any */
+	char *map;
+	size_t mapz;
+} pool = {
+	.mtx = PTHREAD_MUTEX_INITIALIZER,
+	.cnd = PTHREAD_COND_INITIALIZER,
+};
+
+static void
+chnk_line(struct chnk_s *c, struct memo_s *m, const char *str, size_t len)
+{
+	const size_t raw = len;
+
+	len -= len && str[len - 1U] == '\r';
+	line1(&c->out, m, str, len);
+	c->out.ioff += raw + 1U;
+	c->out.lno++;
+	return;
+}
+
+static void
+chck_chnk(struct chnk_s *c, struct memo_s *m)
+{
+	const char *bp = c->buf;
+	const char *const ep = c->buf + c->bsz;
+
+	c->out.bsz = 0U;
+	c->out.ioff = c->ioff;
+	c->out.lno = c->lno;
+	for (const char *eol;
+	     (eol = memchr(bp, '\n', ep - bp)) != NULL; bp = eol + 1U) {
+		chnk_line(c, m, bp, eol - bp);
+	}
+	if (bp < ep) {
+		chnk_line(c, m, bp, ep - bp);
+	}
+	return;
+}
+
+static void*
+wrkr(void *UNUSED(clo))
+{
+	/* every worker has a cache and tallies of its own */
+	struct memo_s *m = memz ? memo_make(memz / njobs) : NULL;
+	struct stat_s st = {0U};
+
+	pthread_mutex_lock(&pool.mtx);
+	while (1) {
+		if (pool.nchk < pool.nfil) {
+			struct chnk_s *c = pool.q + pool.nchk++ % pool.nq;
+
+			pthread_mutex_unlock(&pool.mtx);
+			c->out.stat = &st;
+			chck_chnk(c, m);
+			pthread_mutex_lock(&pool.mtx);
+			c->st = CHNK_DONE;
+			pthread_cond_broadcast(&pool.cnd);
+		} else if (pool.eof) {
+			break;
+		} else {
+			pthread_cond_wait(&pool.cnd, &pool.mtx);
+		}
+	}
+	/* fold our tallies into the global ones */
+	tally.nin += st.nin;
+	tally.nunk += st.nunk;
+	for (size_t i = 0U; i < countof(st.n); i++) {
+		tally.n[i][0U] += st.n[i][0U];
+		tally.n[i][1U] += st.n[i][1U];
+	}
+	pthread_mutex_unlock(&pool.mtx);
+	memo_free(m);
+	return NULL;
+}
+
+static void*
+wrtr(void *UNUSED(clo))
+{
+	pthread_mutex_lock(&pool.mtx);
+	while (1) {
+		struct chnk_s *c = pool.q + pool.nprt % pool.nq;
+
+		if (pool.nprt < pool.nfil && c->st == CHNK_DONE) {
+			pthread_mutex_unlock(&pool.mtx);
+			obuf_flush(&c->out);
+			pthread_mutex_lock(&pool.mtx);
+			c->st = CHNK_FREE;
+			pool.nprt++;
+			pthread_cond_broadcast(&pool.cnd);
+		} else if (pool.eof && pool.nprt >= pool.nfil) {
+			break;
+		} else {
+			pthread_cond_wait(&pool.cnd, &pool.mtx);
+		}
+	}
+	pthread_mutex_unlock(&pool.mtx);
+	return NULL;
+}
+
+static struct chnk_s*
+chnk_get(void)
+{
+	struct chnk_s *c = pool.q + pool.nfil % pool.nq;
+
+	pthread_mutex_lock(&pool.mtx);
+	while (c->st != CHNK_FREE) {
+		pthread_cond_wait(&pool.cnd, &pool.mtx);
+	}
+	pthread_mutex_unlock(&pool.mtx);
+	return c;
+}
+
+static void
+chnk_put(struct chnk_s *c)
+{
+	pthread_mutex_lock(&pool.mtx);
+	c->st = CHNK_FULL;
+	pool.nfil++;
+	pthread_cond_broadcast(&pool.cnd);
+	pthread_mutex_unlock(&pool.mtx);
+	return;
+}
+
+static size_t
+nlcnt(const char *s, size_t n)
+{
+	size_t k = 0U;
+
+	for (size_t i = 0U; i < n; i++) {
+		k += s[i] == '\n';
+	}
+	return k;
+}
+
+static int
+chnk_own(struct chnk_s *c, size_t least)
+{
+	if (UNLIKELY(least > c->ocap)) {
+		const size_t nu = least > CHNK_SIZE * 2U ? least : CHNK_SIZE * 2U;
+		char *tmp = realloc(c->own, nu);
+
+		if (UNLIKELY(tmp == NULL)) {
+			return -1;
+		}
+		c->own = tmp;
+		c->ocap = nu;
+	}
+	c->buf = c->own;
+	return 0;
+}
+
+static int
+feed_map(int fd)
+{
+	struct stat st;
+	off_t off;
+	size_t mz;
+	char *mp;
+
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+		return -1;
+	} else if ((off = lseek(fd, 0, SEEK_CUR)) < 0 || off >= st.st_size) {
+		return -1;
+	}
+	mz = st.st_size;
+	mp = mmap(NULL, mz, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (UNLIKELY(mp == MAP_FAILED)) {
+		return -1;
+	}
+	(void)posix_madvise(mp, mz, POSIX_MADV_SEQUENTIAL);
+
+	for (size_t o = off, eo, nln = 0U; o < mz; o = eo) {
+		struct chnk_s *c = chnk_get();
+		const char *eol;
+
+		if (mz - o <= CHNK_SIZE) {
+			eo = mz;
+		} else if ((eol = memchr(mp + o + CHNK_SIZE, '\n',
+					 mz - o - CHNK_SIZE)) != NULL) {
+			eo = eol + 1U - mp;
+		} else {
+			eo = mz;
+		}
+		if (eo < mz || mp[mz - 1U] == '\n') {
+			c->buf = mp + o;
+		} else if (LIKELY(!chnk_own(c, eo - o + 1U))) {
+			/* unterminated last line, copy so that checkers
+			 * never have to look past the mapping */
+			memcpy(c->own, mp + o, eo - o);
+			c->own[eo - o] = '\0';
+		} else {
+			error("\
+error: cannot allocate memory for input");
+			break;
+		}
+		c->bsz = eo - o;
+		c->ioff = o - off;
+		c->lno = nln;
+		nln += lnop ? nlcnt(c->buf, c->bsz) : 0U;
+		chnk_put(c);
+	}
+	/* the mapping has to outlive the chunks, proc_fd_mt() unmaps it */
+	pool.map = mp;
+	pool.mapz = mz;
+	(void)lseek(fd, 0, SEEK_END);
+	return 0;
+}
+
+static int
+feed_fd(struct dcmp_s *d)
+{
+	struct chnk_s *c = chnk_get();
+	size_t bsz = 0U;
+	size_t ioff = 0U;
+	size_t nln = 0U;
+	ssize_t nrd;
+
+	if (UNLIKELY(chnk_own(c, CHNK_SIZE + 1U) < 0)) {
+		return -1;
+	}
+	while ((nrd = dcmp_read(d, c->own + bsz, c->ocap - bsz - 1U)) > 0) {
+		size_t eo;
+
+		if ((bsz += nrd) + 1U < c->ocap) {
+			/* try and fill the whole chunk */
+			continue;
+		}
+		for (eo = bsz; eo > 0U && c->own[eo - 1U] != '\n'; eo--);
+		if (UNLIKELY(!eo)) {
+			/* line longer than our chunk */
+			if (UNLIKELY(chnk_own(c, c->ocap * 2U) < 0)) {
+				return -1;
+			}
+			continue;
+		}
+		c->bsz = eo;
+		c->ioff = ioff;
+		c->lno = nln;
+		ioff += eo;
+		nln += lnop ? nlcnt(c->buf, c->bsz) : 0U;
+		chnk_put(c);
+		with (struct chnk_s *nu = chnk_get()) {
+			if (UNLIKELY(chnk_own(nu, bsz - eo + CHNK_SIZE) < 0)) {
+				return -1;
+			}
+			memcpy(nu->own, c->own + eo, bsz -= eo);
+			c = nu;
+		}
+	}
+	if (bsz) {
+		c->own[bsz] = '\0';
+		c->bsz = bsz;
+		c->ioff = ioff;
+		c->lno = nln;
+		chnk_put(c);
+	}
+	return nrd < 0 ? -1 : 0;
+}
+
+static int
+proc_fd_mt(int fd, unsigned int nj)
+{
+	pthread_t thr[nj + 1U];
+	unsigned int nt = 0U;
+	struct dcmp_s *d = NULL;
+	int rc = 0;
+
+	pool.nq = 2U * nj + 2U;
+	if (UNLIKELY((pool.q = calloc(pool.nq, sizeof(*pool.q))) == NULL)) {
+		return proc_fd(fd);
+	} else if (UNLIKELY(pthread_create(thr, NULL, wrtr, NULL))) {
+		free(pool.q);
+		return proc_fd(fd);
+	}
+	for (nt = 1U; nt <= nj; nt++) {
+		if (pthread_create(thr + nt, NULL, wrkr, NULL)) {
+			break;
+		}
+	}
+	if (UNLIKELY(nt < 2U)) {
+		/* no workers, do it ourselves */
+		rc = proc_fd(fd);
+	} else if (UNLIKELY((d = dcmp_open(fd)) == NULL)) {
+		rc = -1;
+	} else if (dcmp_codec(d) != NULL || feed_map(fd) < 0) {
+		/* compressed input cannot be mapped */
+		rc = feed_fd(d);
+	}
+
+	pthread_mutex_lock(&pool.mtx);
+	pool.eof = 1;
+	pthread_cond_broadcast(&pool.cnd);
+	pthread_mutex_unlock(&pool.mtx);
+	for (unsigned int i = 0U; i < nt; i++) {
+		pthread_join(thr[i], NULL);
+	}
+	dcmp_close(d);
+	if (pool.map != NULL) {
+		munmap(pool.map, pool.mapz);
+	}
+
+	for (size_t i = 0U; i < pool.nq; i++) {
+		free(pool.q[i].own);
+		free(pool.q[i].out.buf);
+	}
+	free(pool.q);
+	return rc;
+}
 
 
 #include "numchk.yucc"
 
+static ssize_t
+rd_types(nmck_type_t tv[static NMCK_NTYPES], const char *spec, const char *opt)
+{
+/* read comma-separated checker names in SPEC into TV, skip duplicates */
+	unsigned char seen[NMCK_NTYPES] = {0U};
+	size_t n = 0U;
+
+	for (const char *on = spec, *eo; *on; on = eo) {
+		const size_t tl = strcspn(on, ",");
+		const nmck_type_t t = nmck_type_byname(on, tl);
+
+		eo = on + tl + (on[tl] == ',');
+		if (!tl) {
+			continue;
+		} else if (t == NMCK_UNK) {
+			errno = 0;
+			error("\
+error: unknown type `%.*s' in %s", (int)tl, on, opt);
+			return -1;
+		} else if (!seen[t]++) {
+			tv[n++] = t;
+		}
+	}
+	return n;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -131,47 +1495,259 @@ main(int argc, char *argv[])
 		goto out;
 	}
 
+	/* output modes don't mix, --json merely formats the --stats tallies
+	 * and --type narrows down --stats and the validity filters */
+	with (const char *md = NULL) {
+		const int filtp = argi->valid_only_flag || argi->invalid_only_flag;
+		const struct {
+			int set;
+			const char *opt;
+		} mv[] = {
+			{argi->stats_flag, "--stats"},
+			{argi->valid_only_flag, "--valid-only"},
+			{argi->invalid_only_flag, "--invalid-only"},
+			{argi->type_arg && !argi->stats_flag && !filtp, "--type"},
+			{argi->fix_flag, "--fix"},
+			{argi->complete_flag, "--complete"},
+			{argi->suggest_flag, "--suggest"},
+			{argi->range_arg != NULL, "--range"},
+			{argi->binary_flag, "--binary"},
+			{argi->json_flag && !argi->stats_flag, "--json"},
+		};
+
+		for (size_t i = 0U; i < countof(mv); i++) {
+			if (!mv[i].set) {
+				continue;
+			} else if (md != NULL) {
+				errno = 0;
+				error("\
+error: %s and %s cannot be combined", md, mv[i].opt);
+				rc = 1;
+				goto out;
+			}
+			md = mv[i].opt;
+		}
+		/* fields get result columns, or go to the modes above */
+		if ((argi->field_arg || argi->range_arg) && argi->scan_flag) {
+			md = "--scan";
+		} else if (!argi->field_arg ||
+			   !(argi->fix_flag || argi->complete_flag ||
+			     argi->suggest_flag || argi->range_arg)) {
+			break;
+		}
+		errno = 0;
+		error("\
+error: %s and %s cannot be combined",
+		      argi->field_arg ? "--field" : "--range", md);
+		rc = 1;
+		goto out;
+	}
+
 	allp = argi->all_flag;
-	prnt1 = argi->one_line_flag ? prnt1_1ln : prnt1_mln;
-
-	if (!argi->nargs) {
-		char *line = NULL;
-		size_t llen = 0U;
-
-#if defined HAVE_GETLINE
-		for (ssize_t nrd; (nrd = getline(&line, &llen, stdin)) > 0;) {
-			nrd -= nrd > 0 && line[nrd - 1] == '\n';
-			nrd -= nrd > 0 && line[nrd - 1] == '\r';
-			line[nrd] = '\0';
-			chck1(line, nrd);
-			prnt1(line, nrd);
-		}
-		free(line);
-#elif defined HAVE_FGETLN
-		while ((line = fgetln(stdin, &llen)) != NULL) {
-			llen -= llen && line[llen - 1] == '\n';
-			llen -= llen && line[llen - 1] == '\r';
-			line[llen] = '\0';
-			chck1(line, llen);
-			prnt1(line, llen);
-		}
-#else
-		errno = 0, error("\
-error: cannot read from stdin\n\
-getline() or fgetln() support missing.");
-#endif	/* GETLINE/FGETLN */
-		if (ferror(stdin)) {
+	scanp = argi->scan_flag;
+	filt = argi->valid_only_flag ? FILT_VALID
+		: argi->invalid_only_flag ? FILT_INVALID
+		: argi->type_arg ? FILT_TYPE : FILT_NONE;
+	lnop = argi->line_numbers_flag;
+	if (argi->stats_flag) {
+		/* tallies only, no other output */
+		filt = FILT_NONE;
+		obuf.stat = &tally;
+	}
+	prnt1 = argi->stats_flag ? prnt1_stat
+		: filt ? prnt1_filt
+		: argi->fix_flag ? prnt1_fix
+		: argi->complete_flag ? prnt1_cmpl
+		: argi->suggest_flag ? prnt1_sugg
+		: argi->binary_flag ? prnt1_bin
+		: argi->json_flag ? prnt1_json
+		: scanp && argi->one_line_flag ? prnt1_scan1ln
+		: scanp ? prnt1_scan
+		: argi->one_line_flag ? prnt1_1ln : prnt1_mln;
+
+	if (argi->only_arg) {
+		const ssize_t n = rd_types(only, argi->only_arg, "--only");
+
+		if (n < 0) {
+			rc = 1;
+			goto out;
+		}
+		nonly = n;
+	}
+
+	if (argi->type_arg) {
+		nmck_type_t tv[NMCK_NTYPES];
+		const ssize_t n = rd_types(tv, argi->type_arg, "--type");
+
+		if (n < 0) {
+			rc = 1;
+			goto out;
+		}
+		for (ssize_t i = 0; i < n; i++) {
+			ftype[tv[i]] = 1U;
+		}
+		ftypep = n > 0;
+		if (!nonly) {
+			/* no need to dispatch to other checkers */
+			memcpy(only, tv, n * sizeof(*tv));
+			nonly = n;
+		}
+	}
+
+	if (argi->machine_arg) {
+		const char *mn = argi->machine_arg;
+
+		if ((mach = nmck_mach_byname(mn, strlen(mn))) >= NMCK_NMACHS) {
+			errno = 0;
+			error("\
+error: unknown classifier `%s'", mn);
+			rc = 1;
+			goto out;
+		}
+	}
+
+	if (argi->field_arg) {
+		char *on;
+		long int fn = strtol(argi->field_arg, &on, 10);
+
+		if (fn <= 0 || *on) {
+			errno = 0;
+			error("\
+error: field number must be a positive integer");
+			rc = 1;
+			goto out;
+		}
+		fldn = fn;
+		fldr = argi->replace_flag;
+		/* json and binary output describe the field only */
+		fldt = !argi->json_flag && !argi->binary_flag &&
+			!argi->stats_flag;
+	}
+
+	if (argi->delimiter_arg) {
+		const char *dl = argi->delimiter_arg;
+
+		if (!dl[0U] || dl[1U] || dl[0U] == '"' || dl[0U] == '\n') {
+			errno = 0;
+			error("\
+error: delimiter must be a single character other than quote or newline");
+			rc = 1;
+			goto out;
+		}
+		fldd = dl[0U];
+	}
+
+	if (argi->jobs_arg) {
+		long int nj = strtol(argi->jobs_arg, NULL, 0);
+
+		if (nj <= 0) {
+			nj = sysconf(_SC_NPROCESSORS_ONLN);
+		}
+		njobs = nj > 0 ? (unsigned int)nj : 1U;
+	}
+
+	if (argi->range_arg) {
+		char *on;
+		unsigned long long int n = strtoull(argi->range_arg, &on, 10);
+
+		if (*on || !n) {
+			errno = 0;
+			error("\
+error: range count must be a positive number");
+			rc = 1;
+			goto out;
+		}
+		rngn = n;
+		/* output is flushed as we go */
+		njobs = 1U;
+	}
+
+	if (argi->memo_arg) {
+		char *on;
+		unsigned long long int mz = strtoull(argi->memo_arg, &on, 10);
+
+		switch (*on) {
+		case 'G':
+		case 'g':
+			mz <<= 10U;
+		case 'M':
+		case 'm':
+			mz <<= 10U;
+		case 'K':
+		case 'k':
+			mz <<= 10U;
+			on++;
+		default:
+			break;
+		}
+		if (*on || !mz) {
+			errno = 0;
+			error("\
+error: cache size must be a positive number, optionally with K, M or G");
+			rc = 1;
+			goto out;
+		}
+		/* only when output depends on the input line alone */
+		if (!scanp && !fldn && !argi->binary_flag && !(filt && lnop) &&
+		    !argi->stats_flag && !rngn) {
+			memz = mz;
+		}
+		if (memz && (argi->nargs || njobs <= 1U)) {
+			memo = memo_make(memz);
+		}
+	}
+
+	if (argi->cache_arg) {
+		/* results depend on the classifier and the checkers in use */
+		uint64_t salt = (uint64_t)mach << 8U ^ NMCK_NTYPES;
+
+		salt = hash64((const char*)only, nonly * sizeof(*only), salt);
+#if defined HAVE_VERSION_H
+		salt = hash64(package_version, strlen(package_version), salt);
+#endif	/* HAVE_VERSION_H */
+		if ((cache = cache_open(argi->cache_arg, salt)) == NULL) {
+			error("\
+error: cannot use `%s' as cache", argi->cache_arg);
+			rc = 1;
+			goto out;
+		}
+	}
+
+	if (argi->binary_flag) {
+		/* get the header out before any worker output */
+		prnt_bin_hdr(&obuf);
+		obuf_flush(&obuf);
+	}
+
+	if (!argi->nargs && njobs > 1U) {
+		if (proc_fd_mt(STDIN_FILENO, njobs) < 0) {
+			error("\
+error: reading from stdin disrupted");
+			rc = 1;
+		}
+	} else if (!argi->nargs) {
+		if (proc_fd(STDIN_FILENO) < 0) {
 			error("\
 error: reading from stdin disrupted");
+			rc = 1;
 		}
 	} else {
 		for (size_t i = 0U; i < argi->nargs; i++) {
 			const char *str = argi->args[i];
 			const size_t len = strlen(str);
-			chck1(str, len);
-			prnt1(str, len);
+
+			line1(&obuf, memo, str, len);
+			obuf.ioff += len + 1U;
+			obuf.lno++;
 		}
 	}
+	if (argi->stats_flag) {
+		prnt_stat(&obuf, &tally, argi->json_flag);
+	}
+	obuf_flush(&obuf);
+	free(obuf.buf);
+	memo_free(memo);
+	cache_close(cache);
 
 out:
 	yuck_free(argi);
@@ -37,6 +37,7 @@
 #if !defined INCLUDED_numchk_h_
 #define INCLUDED_numchk_h_
 
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -45,17 +46,25 @@
  * For conformant strings the remaining bits can be used to capture state. */
 typedef intptr_t nmck_t;
 
+/**
+ * Printers come in two flavours, nmpr_*() write to stdout and nmfmt_*()
+ * write to a buffer and return the number of bytes written.
+ * The buffer must have room for the input length plus NMFMT_SLACK. */
+#define NMFMT_SLACK	(128U)
+
 /**
  * Generic Luhn check on all-digit input.
  * http://en.wikipedia.org/wiki/Luhn_algorithm */
 extern nmck_t nmck_luhn(const char*, size_t);
 extern void nmpr_luhn(nmck_t, const char*, size_t);
+extern size_t nmfmt_luhn(char*, nmck_t, const char*, size_t);
 
 /**
  * Generic Verhoeff check on all-digit input.
  * http://en.wikipedia.org/wiki/Verhoeff_algorithm */
 extern nmck_t nmck_verhoeff(const char*, size_t);
 extern void nmpr_verhoeff(nmck_t, const char*, size_t);
+extern size_t nmfmt_verhoeff(char*, nmck_t, const char*, size_t);
 
 /**
  * Generic Damm check on all-digit input.
@@ -64,6 +73,7 @@ extern void nmpr_verhoeff(nmck_t, const char*, size_t);
  * Ordnung 10: Computer-Suche, erkennt alle phonetischen Fehler */
 extern nmck_t nmck_damm10(const char*, size_t);
 extern void nmpr_damm10(nmck_t, const char*, size_t);
+extern size_t nmfmt_damm10(char*, nmck_t, const char*, size_t);
 /**
  * Generic Damm check on all-xdigit input.
  * http://en.wikipedia.org/wiki/Damm_algorithm
@@ -71,6 +81,7 @@ extern void nmpr_damm10(nmck_t, const char*, size_t);
  * Ordnung 16: x*y:=2x+y mit Rechnung in GF(2^4) */
 extern nmck_t nmck_damm16(const char*, size_t);
 extern void nmpr_damm16(nmck_t, const char*, size_t);
+extern size_t nmfmt_damm16(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 6166 conformant identifiers, alphanumeric input.
@@ -78,6 +89,7 @@ extern void nmpr_damm16(nmck_t, const char*, size_t);
  * http://www.iso.org/standard/44811.html */
 extern nmck_t nmck_isin(const char*, size_t);
 extern void nmpr_isin(nmck_t, const char*, size_t);
+extern size_t nmfmt_isin(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for OMG conformant FIGIs, alphanumeric input
@@ -85,12 +97,14 @@ extern void nmpr_isin(nmck_t, const char*, size_t);
  * http://openfigi.com/ */
 extern nmck_t nmck_figi(const char*, size_t);
 extern void nmpr_figi(nmck_t, const char*, size_t);
+extern size_t nmfmt_figi(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ABA's and S&P's CUSIP identifier, alphanumeric input.
  * http://en.wikipedia.org/wiki/CUSIP */
 extern nmck_t nmck_cusip(const char*, size_t);
 extern void nmpr_cusip(nmck_t, const char*, size_t);
+extern size_t nmfmt_cusip(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for LSE's SEDOL identifier, alphanumeric input.
@@ -98,6 +112,7 @@ extern void nmpr_cusip(nmck_t, const char*, size_t);
  * http://www.londonstockexchange.com/products-and-services/reference-data/sedol-master-file/documentation/documentation.htm */
 extern nmck_t nmck_sedol(const char*, size_t);
 extern void nmpr_sedol(nmck_t, const char*, size_t);
+extern size_t nmfmt_sedol(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 13616 conformant bank account number, alphanumeric input.
@@ -105,6 +120,7 @@ extern void nmpr_sedol(nmck_t, const char*, size_t);
  * http://www.iso.org/standard/41031.html */
 extern nmck_t nmck_iban(const char*, size_t);
 extern void nmpr_iban(nmck_t, const char*, size_t);
+extern size_t nmfmt_iban(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 17442 conformant legal entity identifiers, alphanumeric input.
@@ -112,6 +128,7 @@ extern void nmpr_iban(nmck_t, const char*, size_t);
  * http://www.iso.org/standard/59771.html */
 extern nmck_t nmck_lei(const char*, size_t);
 extern void nmpr_lei(nmck_t, const char*, size_t);
+extern size_t nmfmt_lei(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for GS1's GTINs, GSINs and SSCCs, numeric input.
@@ -119,6 +136,7 @@ extern void nmpr_lei(nmck_t, const char*, size_t);
  * http://www.gs1.org/services/how-calculate-check-digit-manually */
 extern nmck_t nmck_gtin(const char*, size_t);
 extern void nmpr_gtin(nmck_t, const char*, size_t);
+extern size_t nmfmt_gtin(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 2108 conformant book numbers, numeric input.
@@ -126,25 +144,31 @@ extern void nmpr_gtin(nmck_t, const char*, size_t);
  * http://www.iso.org/standard/36563.html */
 extern nmck_t nmck_isbn(const char*, size_t);
 extern void nmpr_isbn(nmck_t, const char*, size_t);
+extern size_t nmfmt_isbn(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_isbn10(const char*, size_t);
 extern void nmpr_isbn10(nmck_t, const char*, size_t);
+extern size_t nmfmt_isbn10(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_isbn13(const char*, size_t);
 extern void nmpr_isbn13(nmck_t, const char*, size_t);
+extern size_t nmfmt_isbn13(char*, nmck_t, const char*, size_t);
 
 extern nmck_t nmck_credcard(const char*, size_t);
 extern void nmpr_credcard(nmck_t, const char*, size_t);
+extern size_t nmfmt_credcard(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 11649 conformant creditor reference, alphanumeric input.
  * https://www.iso.org/standard/50649.html */
 extern nmck_t nmck_credref(const char*, size_t);
 extern void nmpr_credref(nmck_t, const char*, size_t);
+extern size_t nmfmt_credref(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for the ATO's tax file number, numeric input.
  * http://en.wikipedia.org/wiki/Tax_file_number */
 extern nmck_t nmck_tfn(const char*, size_t);
 extern void nmpr_tfn(nmck_t, const char*, size_t);
+extern size_t nmfmt_tfn(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for CAS's registry numbers, numeric input.
@@ -152,210 +176,473 @@ extern void nmpr_tfn(nmck_t, const char*, size_t);
  * http://support.cas.org/content/counter */
 extern nmck_t nmck_cas(const char*, size_t);
 extern void nmpr_cas(nmck_t, const char*, size_t);
+extern size_t nmfmt_cas(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 21047 conformant text codes, hex-numeric input.
  * http://en.wikipedia.org/wiki/International_Standard_Text_Code */
 extern nmck_t nmck_istc(const char*, size_t);
 extern void nmpr_istc(nmck_t, const char*, size_t);
+extern size_t nmfmt_istc(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 3297 conformant serial numbers, numeric input.
  * http://en.wikipedia.org/wiki/International_Standard_Serial_Number */
 extern nmck_t nmck_issn(const char*, size_t);
 extern void nmpr_issn(nmck_t, const char*, size_t);
+extern size_t nmfmt_issn(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_issn8(const char*, size_t);
 extern void nmpr_issn8(nmck_t, const char*, size_t);
+extern size_t nmfmt_issn8(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_issn13(const char*, size_t);
 extern void nmpr_issn13(nmck_t, const char*, size_t);
+extern size_t nmfmt_issn13(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 10957 conformant music number, numeric input.
  * http://en.wikipedia.org/wiki/International_Standard_Music_Number */
 extern nmck_t nmck_ismn(const char*, size_t);
 extern void nmpr_ismn(nmck_t, const char*, size_t);
+extern size_t nmfmt_ismn(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_ismn10(const char*, size_t);
 extern void nmpr_ismn10(nmck_t, const char*, size_t);
+extern size_t nmfmt_ismn10(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_ismn13(const char*, size_t);
 extern void nmpr_ismn13(nmck_t, const char*, size_t);
+extern size_t nmfmt_ismn13(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ISO 27729 conformant name identifier, numeric input.
  * http://en.wikipedia.org/wiki/International_Standard_Name_Identifier */
 extern nmck_t nmck_isni(const char*, size_t);
 extern void nmpr_isni(nmck_t, const char*, size_t);
+extern size_t nmfmt_isni(char*, nmck_t, const char*, size_t);
 
 /**
  * ISO 15706 conformant audiovisual number, hex-numeric input.
  * http://en.wikipedia.org/wiki/International_Standard_Audiovisual_Number */
 extern nmck_t nmck_isan(const char*, size_t);
 extern void nmpr_isan(nmck_t, const char*, size_t);
+extern size_t nmfmt_isan(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for IMO's vessel number, numeric input.
  * http://en.wikipedia.org/wiki/IMO_number */
 extern nmck_t nmck_imo(const char*, size_t);
 extern void nmpr_imo(nmck_t, const char*, size_t);
+extern size_t nmfmt_imo(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for vehicle identification numbers, alphanumeric input.
  * http://en.wikipedia.org/wiki/Vehicle_identification_number */
 extern nmck_t nmck_vin(const char*, size_t);
 extern void nmpr_vin(nmck_t, const char*, size_t);
+extern size_t nmfmt_vin(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for the global release identifier, alphanumeric input.
  * http://en.wikipedia.org/wiki/Global_Release_Identifier */
 extern nmck_t nmck_grid(const char*, size_t);
 extern void nmpr_grid(nmck_t, const char*, size_t);
+extern size_t nmfmt_grid(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for BIC's container number, alphanumeric input.
  * http://www.bic-code.org/ */
 extern nmck_t nmck_bicc(const char*, size_t);
 extern void nmpr_bicc(nmck_t, const char*, size_t);
+extern size_t nmfmt_bicc(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for VAT identity numbers of EU member states, alphanumeric input.
  * http://en.wikipedia.org/wiki/VAT_identification_number#European_Union_VAT_identification_numbers */
 extern nmck_t nmck_euvatid(const char*, size_t);
 extern void nmpr_euvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_euvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_devatid(const char*, size_t);
 extern void nmpr_devatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_devatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_bevatid(const char*, size_t);
 extern void nmpr_bevatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_bevatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_dkvatid(const char*, size_t);
 extern void nmpr_dkvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_dkvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_fivatid(const char*, size_t);
 extern void nmpr_fivatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_fivatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_frvatid(const char*, size_t);
 extern void nmpr_frvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_frvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_grvatid(const char*, size_t);
 extern void nmpr_grvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_grvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_ievatid(const char*, size_t);
 extern void nmpr_ievatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_ievatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_itvatid(const char*, size_t);
 extern void nmpr_itvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_itvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_luvatid(const char*, size_t);
 extern void nmpr_luvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_luvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_nlvatid(const char*, size_t);
 extern void nmpr_nlvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_nlvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_atvatid(const char*, size_t);
 extern void nmpr_atvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_atvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_plvatid(const char*, size_t);
 extern void nmpr_plvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_plvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_ptvatid(const char*, size_t);
 extern void nmpr_ptvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_ptvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_sevatid(const char*, size_t);
 extern void nmpr_sevatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_sevatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_sivatid(const char*, size_t);
 extern void nmpr_sivatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_sivatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_esvatid(const char*, size_t);
 extern void nmpr_esvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_esvatid(char*, nmck_t, const char*, size_t);
 extern nmck_t nmck_ukvatid(const char*, size_t);
 extern void nmpr_ukvatid(nmck_t, const char*, size_t);
+extern size_t nmfmt_ukvatid(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for SWIFT's business identifiers, alphanumeric input.
  * http://en.wikipedia.org/wiki/ISO_9362 */
 extern nmck_t nmck_bic(const char*, size_t);
 extern void nmpr_bic(nmck_t, const char*, size_t);
+extern size_t nmfmt_bic(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for WM Daten's Wertpapierkennummer, alphanumeric input.
  * http://en.wikipedia.org/wiki/Wertpapierkennnummer */
 extern nmck_t nmck_wkn(const char*, size_t);
 extern void nmpr_wkn(nmck_t, const char*, size_t);
+extern size_t nmfmt_wkn(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for mobile equipment identity numbers, numeric input.
  * http://en.wikipedia.org/wiki/International_Mobile_Equipment_Identity */
 extern nmck_t nmck_imei(const char*, size_t);
 extern void nmpr_imei(nmck_t, const char*, size_t);
+extern size_t nmfmt_imei(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Iceland's personal identification number, numeric input.
  * http://en.wikipedia.org/wiki/Kennitala */
 extern nmck_t nmck_kennitala(const char*, size_t);
 extern void nmpr_kennitala(nmck_t, const char*, size_t);
+extern size_t nmfmt_kennitala(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Turkey's personal identification number, numeric input.
  * http://en.wikipedia.org/wiki/Turkish_Identification_Number */
 extern nmck_t nmck_tckimlik(const char*, size_t);
 extern void nmpr_tckimlik(nmck_t, const char*, size_t);
+extern size_t nmfmt_tckimlik(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for India's personal identification number, numeric input.
  * http://en.wikipedia.org/wiki/Aadhaar */
 extern nmck_t nmck_aadhaar(const char*, size_t);
 extern void nmpr_aadhaar(nmck_t, const char*, size_t);
+extern size_t nmfmt_aadhaar(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Brazil's personal identification number, numeric input.
  * http://pt.wikipedia.org/wiki/T%C3%ADtulo_eleitoral */
 extern nmck_t nmck_titulo_eleitoral(const char*, size_t);
 extern void nmpr_titulo_eleitoral(nmck_t, const char*, size_t);
+extern size_t nmfmt_titulo_eleitoral(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Brazil's taxpayer identification number, numeric input.
  * http://en.wikipedia.org/wiki/Cadastro_de_Pessoas_F%C3%ADsicas */
 extern nmck_t nmck_cpf(const char*, size_t);
 extern void nmpr_cpf(nmck_t, const char*, size_t);
+extern size_t nmfmt_cpf(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for IPOS's application numbers, alphanumeric input.
  * http://blog.cantab-ip.com/blog/2014/01/20/new-format-for-singapore-ip-application-numbers-at-ipos/ */
 extern nmck_t nmck_iposan(const char*, size_t);
 extern void nmpr_iposan(nmck_t, const char*, size_t);
+extern size_t nmfmt_iposan(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for CMS's national provider identifier, numeric input.
  * http://en.wikipedia.org/wiki/National_Provider_Identifier */
 extern nmck_t nmck_npi(const char*, size_t);
 extern void nmpr_npi(nmck_t, const char*, size_t);
+extern size_t nmfmt_npi(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for ABA's routing transit number, numeric input.
  * http://en.wikipedia.org/wiki/ABA_routing_transit_number */
 extern nmck_t nmck_abartn(const char*, size_t);
 extern void nmpr_abartn(nmck_t, const char*, size_t);
+extern size_t nmfmt_abartn(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for New Zealand's national health index, numeric input.
  * http://en.wikipedia.org/wiki/NHI_Number */
 extern nmck_t nmck_nhi(const char*, size_t);
 extern void nmpr_nhi(nmck_t, const char*, size_t);
+extern size_t nmfmt_nhi(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Ireland's personal public service number, numeric input.
  * http://en.wikipedia.org/wiki/Personal_Public_Service_Number */
 extern nmck_t nmck_ppsn(const char*, size_t);
 extern void nmpr_ppsn(nmck_t, const char*, size_t);
+extern size_t nmfmt_ppsn(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Germany's taxpayer identification number, numeric input.
  * http://en.wikipedia.org/wiki/National_identification_number#Germany */
 extern nmck_t nmck_idnr(const char*, size_t);
 extern void nmpr_idnr(nmck_t, const char*, size_t);
+extern size_t nmfmt_idnr(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for Croatia's personal identification number, numeric input.
  * http://en.wikipedia.org/wiki/Personal_identification_number_(Croatia) */
 extern nmck_t nmck_oib(const char*, size_t);
 extern void nmpr_oib(nmck_t, const char*, size_t);
+extern size_t nmfmt_oib(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for the UK's national health service number, numeric input.
  * http://en.wikipedia.org/wiki/NHS_number */
 extern nmck_t nmck_nhs(const char*, size_t);
 extern void nmpr_nhs(nmck_t, const char*, size_t);
+extern size_t nmfmt_nhs(char*, nmck_t, const char*, size_t);
 
 /**
  * Check for unique pupil numbers, alphanumeric input.
  * https://www.gov.uk/government/publications/unique-pupil-numbers */
 extern nmck_t nmck_upn(const char*, size_t);
 extern void nmpr_upn(nmck_t, const char*, size_t);
+extern size_t nmfmt_upn(char*, nmck_t, const char*, size_t);
+
+
+/* classification */
+/**
+ * All checkers, X(x) for every nmck_x()/nmpr_x() pair. */
+#define NMCK_TYPES(X)	\
+	X(luhn) X(verhoeff) X(damm10) X(damm16) X(isin) X(figi)	\
+	X(cusip) X(sedol) X(iban) X(lei) X(gtin) X(isbn) X(isbn10)	\
+	X(isbn13) X(credcard) X(credref) X(tfn) X(cas) X(istc) X(issn)	\
+	X(issn8) X(issn13) X(ismn) X(ismn10) X(ismn13) X(isni) X(isan)	\
+	X(imo) X(vin) X(grid) X(bicc) X(devatid) X(bevatid) X(dkvatid)	\
+	X(fivatid) X(frvatid) X(grvatid) X(ievatid) X(itvatid)	\
+	X(luvatid) X(nlvatid) X(atvatid) X(plvatid) X(ptvatid)	\
+	X(sevatid) X(sivatid) X(esvatid) X(ukvatid) X(bic) X(wkn)	\
+	X(imei) X(kennitala) X(tckimlik) X(aadhaar) X(titulo_eleitoral)	\
+	X(cpf) X(iposan) X(npi) X(abartn) X(nhi) X(ppsn) X(idnr) X(oib)	\
+	X(nhs) X(upn)
+
+/**
+ * Checker identifiers, 0 means unknown. */
+typedef enum {
+	NMCK_UNK,
+#define NMCK_TYPE(x)	NMCK_##x,
+	NMCK_TYPES(NMCK_TYPE)
+#undef NMCK_TYPE
+	NMCK_NTYPES
+} nmck_type_t;
+
+/**
+ * Classification result of a single checker. */
+struct nmck_result {
+	/** the checker in question */
+	nmck_type_t type;
+	/** 0 for conformant input, 1 for non-conformant input */
+	unsigned char status;
+	/** 1 for conclusive results, 0 for mere candidates */
+	unsigned char sure;
+	/** number of suggested check characters, 0 if there's no suggestion */
+	unsigned char nchk;
+	/** suggested check characters and their offsets in the input */
+	char chk[2U];
+	unsigned int off[2U];
+	/** raw checker state, see nmck_t */
+	nmck_t state;
+};
+
+/**
+ * Fill in the status and the suggested check characters of RES from its
+ * type, state and sure flag, e.g. for results that were stored as just
+ * these.  STR of length LEN is the input they belong to. */
+extern void nmck_decode(struct nmck_result *res, const char *str, size_t len);
+
+/**
+ * Return the name of checker T, the X in nmck_X(), or "unknown". */
+extern const char *nmck_type_name(nmck_type_t t);
+
+/**
+ * Return the checker whose name is the LEN characters of NAME,
+ * NMCK_UNK if there is no such checker. */
+extern nmck_type_t nmck_type_byname(const char *name, size_t len);
+
+/**
+ * Classify STR of length LEN and store results in RES which must have
+ * room for NMCK_NTYPES results.  Conclusive results come first.
+ * Return the number of results, 0 means unknown.
+ * This function is reentrant and does not perform any I/O. */
+extern size_t nmck_classify(const char*, size_t, struct nmck_result*);
+
+/**
+ * Dispatchers, the full one and smaller ones for known kinds of input. */
+typedef enum {
+	/** all checkers, what nmck_classify() uses */
+	NMCK_MACH_FULL,
+	/** isin, figi, cusip, sedol, lei, iban, bic, wkn, credref */
+	NMCK_MACH_FIN,
+	/** euvatid, idnr, cpf, tfn, tckimlik, kennitala, ppsn, oib */
+	NMCK_MACH_TAX,
+	/** isbn, issn, ismn, isni, istc, isan */
+	NMCK_MACH_PUB,
+	NMCK_NMACHS
+} nmck_mach_t;
+
+/**
+ * Return the dispatcher called NAME of length LEN, one of full,
+ * financial, tax or publishing, or NMCK_NMACHS if there is none. */
+extern nmck_mach_t nmck_mach_byname(const char *name, size_t len);
+
+/**
+ * Like nmck_classify() but use dispatcher M. */
+extern size_t
+nmck_classify_mach(
+	nmck_mach_t m, const char *str, size_t len, struct nmck_result *res);
+
+/**
+ * Like nmck_classify() but only consult the NTY checkers in TY, the
+ * dispatcher still vets the input's shape but calls no other checkers.
+ * Results are those of nmck_classify() restricted to TY, except that
+ * isbn, issn and ismn report their variants under their own name. */
+extern size_t
+nmck_classify_only(
+	const char *str, size_t len,
+	const nmck_type_t *ty, size_t nty, struct nmck_result *res);
+
+/**
+ * Classify N strings laid out Arrow-style, i.e. string I is the byte
+ * range [OFF[I], OFF[I + 1]) of BUF, so OFF has N + 1 entries.
+ * Results are stored in RES, which has room for NRES results, without
+ * gaps: the results of string I are RES[ROFF[I]] to RES[ROFF[I + 1] - 1]
+ * and ROFF must have room for N + 1 entries.
+ * Return the number of strings classified which is less than N if RES
+ * ran out of room, call again with the remaining strings then.
+ * This function is reentrant and does not perform any I/O. */
+extern size_t
+nmck_classify_batch(
+	const char *buf, const int32_t *off, size_t n,
+	struct nmck_result *res, size_t nres, int32_t *roff);
+
+/**
+ * Return the first of the NRES results in RES whose suggested check
+ * characters go exactly where STR of length LEN has placeholders, `_'
+ * or `?', or NULL if there's no such result. */
+extern const struct nmck_result*
+nmck_completion(
+	const struct nmck_result *res, size_t nres, const char *str, size_t len);
+
+/**
+ * Fill in the check character placeholders of STR of length LEN, e.g.
+ * US037833100_ becomes US0378331005, using the first checker able to.
+ * Only the NTY checkers in TY are consulted unless NTY is 0.
+ * Return the checker used or NMCK_UNK if STR was left untouched.
+ * This function is reentrant and does not perform any I/O. */
+extern nmck_type_t
+nmck_complete(char *str, size_t len, const nmck_type_t *ty, size_t nty);
+
+/**
+ * Single-error correction of an input, see nmck_suggest(). */
+struct nmck_sugg {
+	/** the checker the corrected input is conformant with */
+	nmck_type_t type;
+	/** 0 for a look-alike character, e.g. O for 0, 1 for swapped
+	 * neighbours, 2 for another digit for a digit or another letter
+	 * for a letter, 3 for any other character */
+	unsigned int rank;
+	/** offset of the (first) character to replace */
+	unsigned int off;
+	/** the replacement, CHR[1] replaces the character after OFF
+	 * if RANK is 1 */
+	char chr[2U];
+};
+
+/**
+ * Find every substitution of a single character and every swap of two
+ * neighbouring characters that makes STR of length LEN conformant with
+ * checker T.  Corrections are stored in RES, best ranked ones first,
+ * and the number of corrections is returned which may exceed NRES in
+ * which case the excess ones are not stored.
+ * This function is reentrant and does not perform any I/O. */
+extern size_t
+nmck_suggest(
+	nmck_type_t t, const char *str, size_t len,
+	struct nmck_sugg *res, size_t nres);
+
+/**
+ * Check digit algorithms that can be fed one character at a time. */
+typedef enum {
+	/** Luhn mod 10, credit cards, IMEIs */
+	NMCK_ALGO_LUHN,
+	/** weights 3 and 1 from the right, mod 10, GTINs, ISBN-13s */
+	NMCK_ALGO_MOD10_31,
+	/** weights 1, 2, 3, ... from the right, mod 11 with X for 10,
+	 * ISBN-10s, ISSNs */
+	NMCK_ALGO_MOD11,
+	/** ISO 7064 MOD 97-10, LEIs */
+	NMCK_ALGO_MOD97,
+	/** ISO 7064 MOD 97-10 with the first 4 characters moved to the
+	 * end, IBANs, RF creditor references */
+	NMCK_ALGO_MOD97_ROT4,
+	/** Damm over decimal and hexadecimal digits */
+	NMCK_ALGO_DAMM10,
+	NMCK_ALGO_DAMM16,
+	/** Verhoeff */
+	NMCK_ALGO_VERHOEFF,
+	NMCK_NALGOS
+} nmck_algo_t;
+
+/**
+ * Running state of a check digit algorithm, a plain value that can be
+ * copied to go back to an earlier input, e.g. on backspace. */
+struct nmck_state {
+	nmck_algo_t algo;
+	/** number of characters fed, blanks and dashes aside */
+	unsigned int len;
+	/** non-0 once a character the algorithm can't take was fed */
+	unsigned int err;
+	/** running sums or products, depending on ALGO */
+	unsigned int s[8U];
+	char head[4U];
+};
+
+/**
+ * Prepare ST for algorithm A, return -1 if there's no such algorithm. */
+extern int nmck_state_init(struct nmck_state *st, nmck_algo_t a);
+
+/**
+ * Append character C to the input of ST in O(1), blanks and dashes are
+ * ignored.  Return -1 if C cannot be part of the input, ST is unusable
+ * then. */
+extern int nmck_state_feed(struct nmck_state *st, char c);
+
+/**
+ * Return 0 if the input fed to ST so far is conformant, 1 if it is not
+ * and -1 if it's too short or contained invalid characters.
+ * ST can be fed further afterwards. */
+extern int nmck_state_final(const struct nmck_state *st);
 
 
 /* utils */
@@ -1,58 +1,11 @@
 #include <string.h>
 #include <stdio.h>
-#include "numchk.h"
-#include "nifty.h"
-
-#define NNMCK	(64U)
-
-#define maybe(x, y)	\
-	candpr[ncand] = nmpr_##x; \
-	candck[ncand] = y; \
-	ncand++
-#define defo(x, y)	\
-	surepr[nsure] = nmpr_##x; \
-	sureck[nsure] = y; \
-	nsure++
-
-#define c(x)	\
-	with (nmck_t y = nmck_##x(str, len)) { \
-		if (y < 0) { \
-			break; \
-		} else if (y & 0b1U) { \
-			maybe(x, y); \
-		} else { \
-			defo(x, y); \
-		} \
-	}
-#define g(x)	\
-	with (nmck_t y = nmck_##x(str, len)) { \
-		if (y < 0) { \
-			break; \
-		} else { \
-			maybe(x, y); \
-		} \
-	}
-
-#ifdef __INTEL_COMPILER
-# pragma warning (disable:2415)
-#endif  /* __INTEL_COMPILER */
-
-static size_t ncand;
-static void(*candpr[NNMCK])(nmck_t, const char*, size_t);
-static nmck_t candck[NNMCK];
-static size_t nsure;
-static void(*surepr[NNMCK])(nmck_t, const char*, size_t);
-static nmck_t sureck[NNMCK];
+#include "dispatch.h"
 
 %%{
 	machine numchk;
 
-	upnum = digit | upper;
-	lonum = digit | lower;
-	check = "_" | "?";
-	vowel = "A" | "E" | "I" | "O" | "U";
-	consonant = upper - vowel;
-
+	include numchk "dispatch.h";
 	include numchk "aadhaar.c";
 	include numchk "abartn.c";
 	include numchk "bic.c";
@@ -135,7 +88,7 @@ static nmck_t sureck[NNMCK];
 		upn |
 
 		## generic checks
-		digit{2,} %{g(luhn)} %{g(verhoeff)} %{g(damm10)} |
+		digit{2,} %{gd(luhn)} %{gd(verhoeff)} %{gd(damm10)} |
 		xdigit{2,} %{g(damm16)} |
 
 		any*;
@@ -144,15 +97,18 @@ static nmck_t sureck[NNMCK];
 }%%
 
 static int
-chck1(const char *str, size_t len)
+chck1(struct chck_s *restrict ctx, const char *str, size_t len)
 {
 	const char *p = str;
 	const char *const pe = str + len;
 	const char *const eof = pe;
+	struct nmdg_s dg[1U];
 	int cs;
 
 	%% write init;
-	ncand = nsure = 0U;
+	ctx->ncand = ctx->nsure = 0U;
+	/* convert and sum up all-digit input once for all digit checkers */
+	nmdg_scan(dg, str, len);
 
 	%% write exec;
 	return 0;
@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -82,19 +83,28 @@ nmck_ppsn(const char *str, size_t len)
 	return sum << 1U ^ ((char)sum != str[7U]);
 }
 
-void
-nmpr_ppsn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_ppsn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("PPS No, conformant", stdout);
+		bp = fmt_lit(bp, "PPS No, conformant");
 	} else if (s > 0 && len > 7U) {
-		fputs("PPS No, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 7U, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
-		fwrite(str + 8U, sizeof(*str), len - 8U, stdout);
+		bp = fmt_lit(bp, "PPS No, not conformant, should be ");
+		bp = fmt_mem(bp, str, 7U);
+		*bp++ = (char)(s >> 1 & 0x7f);
+		bp = fmt_mem(bp, str + 8U, len - 8U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_ppsn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_ppsn, s, str, len);
 	return;
 }
 
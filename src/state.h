@@ -0,0 +1,65 @@
+/*** state.h -- incremental check digit algorithms
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#if !defined INCLUDED_state_h_
+#define INCLUDED_state_h_
+
+#include "numchk.h"
+
+/* Feeders take the next character C, they return -1 if C is
+ * unacceptable and leave the counting of characters to the caller,
+ * i.e. ST->len is the number of characters before C.
+ * Finalisers return like nmck_state_final(). */
+extern int luhn_feed(struct nmck_state *st, char c);
+extern int luhn_final(const struct nmck_state *st);
+
+extern int gtin_feed(struct nmck_state *st, char c);
+extern int gtin_final(const struct nmck_state *st);
+
+extern int isbn_feed(struct nmck_state *st, char c);
+extern int isbn_final(const struct nmck_state *st);
+
+extern int mod97_feed(struct nmck_state *st, char c);
+extern int mod97_final(const struct nmck_state *st);
+
+extern int damm10_feed(struct nmck_state *st, char c);
+extern int damm16_feed(struct nmck_state *st, char c);
+extern int damm_final(const struct nmck_state *st);
+
+extern int verhoeff_feed(struct nmck_state *st, char c);
+extern int verhoeff_final(const struct nmck_state *st);
+
+#endif	/* INCLUDED_state_h_ */
@@ -0,0 +1,339 @@
+/*** suggest.c -- single-error corrections
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdlib.h>
+#include <string.h>
+#include "numchk.h"
+#include "mod97.h"
+#include "nifty.h"
+
+/* longest input we bother with, IBANs with blanks are 42 */
+#define SUGG_MAXLEN	64U
+
+/* Substitutions and transpositions are screened by the checksum the
+ * checker in question is built on before the checker proper gets to
+ * see them.  The screens are updated in O(1) per candidate:
+ * - Luhn, from the digit sum and the contribution of each digit,
+ * - MOD 97-10, from the remainders of every prefix and every suffix
+ *   of the digit expansion, possibly rotated as for IBANs.
+ * Checkers without a screen see every candidate. */
+typedef enum {
+	SCRN_NONE,
+	SCRN_LUHN,
+	SCRN_M97,
+	/* the first 4 characters go last */
+	SCRN_M97_ROT4,
+} scrn_t;
+
+static const scrn_t scrn[NMCK_NTYPES] = {
+	[NMCK_luhn] = SCRN_LUHN,
+	[NMCK_credcard] = SCRN_LUHN,
+	[NMCK_lei] = SCRN_M97,
+	[NMCK_iban] = SCRN_M97_ROT4,
+	[NMCK_credref] = SCRN_M97_ROT4,
+};
+
+/* characters easily mistaken for one another, by OCR or by eye, share
+ * a non-0 group */
+static const unsigned char ocr[0x80U] = {
+	['0'] = 1U, ['O'] = 1U, ['D'] = 1U, ['Q'] = 1U,
+	['1'] = 2U, ['I'] = 2U, ['L'] = 2U, ['7'] = 2U, ['T'] = 2U,
+	['2'] = 3U, ['Z'] = 3U,
+	['5'] = 4U, ['S'] = 4U,
+	['6'] = 5U, ['G'] = 5U,
+	['8'] = 6U, ['B'] = 6U,
+	['U'] = 7U, ['V'] = 7U,
+};
+
+static const char alnum[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/* the Luhn value of a doubled digit */
+static const unsigned char luhn_dbl[10U] = {
+	0U, 2U, 4U, 6U, 8U, 1U, 3U, 5U, 7U, 9U,
+};
+
+struct scrn_s {
+	scrn_t s;
+	/* Luhn, digit sum and the parity of every digit */
+	unsigned int sum;
+	unsigned char par[SUGG_MAXLEN];
+	/* MOD 97-10, position of every character in the folding order,
+	 * prefix and suffix remainders and the number of decimal digits
+	 * of every suffix */
+	unsigned char pos[SUGG_MAXLEN];
+	unsigned char seq[SUGG_MAXLEN];
+	unsigned int nseq;
+	unsigned char pre[SUGG_MAXLEN + 1U];
+	unsigned char suf[SUGG_MAXLEN + 1U];
+	unsigned char ndig[SUGG_MAXLEN + 1U];
+	unsigned char p10[2U * SUGG_MAXLEN + 1U];
+};
+
+static inline unsigned int
+luhn_val(unsigned int par, char c)
+{
+	const unsigned int d = (unsigned char)(c ^ '0');
+
+	return par ? luhn_dbl[d] : d;
+}
+
+static inline unsigned int
+m97_fold(unsigned int r, char c)
+{
+	const unsigned int v = mod97_val(c);
+
+	return (r * (v < 10U ? 10U : 100U) + v) % 97U;
+}
+
+static int
+scrn_init(struct scrn_s *restrict sc, scrn_t s, const char *str, size_t len)
+{
+/* set up screen S for STR, return -1 if STR doesn't fit the screen */
+	sc->s = s;
+	switch (s) {
+	case SCRN_LUHN:
+		sc->sum = 0U;
+		for (size_t i = len, k = 0U; i-- > 0U;) {
+			if ((unsigned char)(str[i] ^ '0') < 10U) {
+				sc->par[i] = (unsigned char)(k++ & 0b1U);
+				sc->sum += luhn_val(sc->par[i], str[i]);
+			} else if (str[i] != ' ') {
+				return -1;
+			}
+		}
+		return 0;
+	case SCRN_M97:
+	case SCRN_M97_ROT4:
+		break;
+	default:
+		return 0;
+	}
+
+	/* the folding order, blanks are skipped */
+	sc->nseq = 0U;
+	with (size_t rot = s == SCRN_M97_ROT4 && len > 4U ? 4U : 0U) {
+		for (size_t j = 0U; j < len; j++) {
+			const size_t i = (j + rot) % len;
+
+			if (str[i] == ' ') {
+				sc->pos[i] = 0xffU;
+				continue;
+			} else if (mod97_val(str[i]) >= 36U) {
+				return -1;
+			}
+			sc->pos[i] = (unsigned char)sc->nseq;
+			sc->seq[sc->nseq++] = (unsigned char)i;
+		}
+	}
+	sc->pre[0U] = 0U;
+	for (size_t q = 0U; q < sc->nseq; q++) {
+		sc->pre[q + 1U] = (unsigned char)m97_fold(sc->pre[q], str[sc->seq[q]]);
+	}
+	sc->p10[0U] = 1U;
+	for (size_t k = 1U; k < countof(sc->p10); k++) {
+		sc->p10[k] = (unsigned char)(sc->p10[k - 1U] * 10U % 97U);
+	}
+	sc->suf[sc->nseq] = 0U;
+	sc->ndig[sc->nseq] = 0U;
+	for (size_t q = sc->nseq; q-- > 0U;) {
+		const unsigned int v = mod97_val(str[sc->seq[q]]);
+
+		sc->suf[q] = (unsigned char)
+			((v * sc->p10[sc->ndig[q + 1U]] + sc->suf[q + 1U]) % 97U);
+		sc->ndig[q] = (unsigned char)(sc->ndig[q + 1U] + 1U + (v >= 10U));
+	}
+	return 0;
+}
+
+static int
+scrn_subst(const struct scrn_s *sc, const char *str, size_t i, char c)
+{
+/* return non-0 if STR with C at I might pass */
+	switch (sc->s) {
+		unsigned int q, r;
+
+	case SCRN_LUHN:
+		if ((unsigned char)(c ^ '0') >= 10U || str[i] == ' ') {
+			return 0;
+		}
+		r = sc->sum - luhn_val(sc->par[i], str[i]) + luhn_val(sc->par[i], c);
+		return !(r % 10U);
+	case SCRN_M97:
+	case SCRN_M97_ROT4:
+		if ((q = sc->pos[i]) >= sc->nseq || mod97_val(c) >= 36U) {
+			return 0;
+		}
+		r = m97_fold(sc->pre[q], c);
+		r = (r * sc->p10[sc->ndig[q + 1U]] + sc->suf[q + 1U]) % 97U;
+		return r == 1U;
+	default:
+		break;
+	}
+	return 1;
+}
+
+static int
+scrn_swap(const struct scrn_s *sc, const char *str, size_t i)
+{
+/* return non-0 if STR with the characters at I and I + 1 swapped
+ * might pass */
+	const char a = str[i + 0U];
+	const char b = str[i + 1U];
+
+	switch (sc->s) {
+		unsigned int q, r;
+
+	case SCRN_LUHN:
+		if (a == ' ' || b == ' ') {
+			return 0;
+		}
+		r = sc->sum -
+			luhn_val(sc->par[i], a) - luhn_val(sc->par[i + 1U], b) +
+			luhn_val(sc->par[i], b) + luhn_val(sc->par[i + 1U], a);
+		return !(r % 10U);
+	case SCRN_M97:
+	case SCRN_M97_ROT4:
+		if ((q = sc->pos[i]) >= sc->nseq || sc->pos[i + 1U] != q + 1U) {
+			/* not neighbours in the folding order, let the
+			 * checker decide */
+			return sc->pos[i] < sc->nseq && sc->pos[i + 1U] < sc->nseq;
+		}
+		r = m97_fold(m97_fold(sc->pre[q], b), a);
+		r = (r * sc->p10[sc->ndig[q + 2U]] + sc->suf[q + 2U]) % 97U;
+		return r == 1U;
+	default:
+		break;
+	}
+	return 1;
+}
+
+static inline int
+conformp(nmck_type_t t, const char *str, size_t len)
+{
+	struct nmck_result res[NMCK_NTYPES];
+
+	return nmck_classify_only(str, len, &t, 1U, res) && !res->status;
+}
+
+static inline int
+digitp(char c)
+{
+	return (unsigned char)(c ^ '0') < 10U;
+}
+
+static inline int
+alnump(char c)
+{
+	return (unsigned char)(c ^ '0') < 10U ||
+		(unsigned char)((c | 0x20) - 'a') < 26U;
+}
+
+
+size_t
+nmck_suggest(
+	nmck_type_t t, const char *str, size_t len,
+	struct nmck_sugg *res, size_t nres)
+{
+	struct scrn_s sc;
+	char buf[SUGG_MAXLEN];
+	size_t n = 0U;
+
+	if (UNLIKELY(t <= NMCK_UNK || t >= NMCK_NTYPES)) {
+		return 0U;
+	} else if (UNLIKELY(len < 2U || len > sizeof(buf))) {
+		return 0U;
+	} else if (scrn_init(&sc, scrn[t], str, len) < 0) {
+		/* fine, no screening then */
+		sc.s = SCRN_NONE;
+	}
+	memcpy(buf, str, len);
+
+	/* look-alikes first, then swaps, then digits for digits and
+	 * letters for letters, then everything else */
+	for (unsigned int rank = 0U; rank < 4U; rank++) {
+		for (size_t i = 0U; i < len; i++) {
+			const char a = str[i];
+
+			if (!alnump(a)) {
+				continue;
+			} else if (rank == 1U) {
+				if (i + 1U >= len || a == str[i + 1U] ||
+				    !alnump(str[i + 1U])) {
+					continue;
+				} else if (!scrn_swap(&sc, str, i)) {
+					continue;
+				}
+				buf[i + 0U] = str[i + 1U];
+				buf[i + 1U] = a;
+				if (conformp(t, buf, len)) {
+					if (n < nres) {
+						res[n] = (struct nmck_sugg){
+							t, rank, i,
+							{str[i + 1U], a}};
+					}
+					n++;
+				}
+				buf[i + 0U] = a;
+				buf[i + 1U] = str[i + 1U];
+				continue;
+			}
+			for (size_t k = 0U; k < countof(alnum) - 1U; k++) {
+				const char c = alnum[k];
+				const unsigned int g = ocr[(unsigned char)a];
+				const unsigned int r = g && g == ocr[(unsigned char)c]
+					? 0U : 2U + (digitp(a) != digitp(c));
+
+				if (c == a || r != rank) {
+					continue;
+				} else if (!scrn_subst(&sc, str, i, c)) {
+					continue;
+				}
+				buf[i] = c;
+				if (conformp(t, buf, len)) {
+					if (n < nres) {
+						res[n] = (struct nmck_sugg){
+							t, rank, i, {c, '\0'}};
+					}
+					n++;
+				}
+			}
+			buf[i] = a;
+		}
+	}
+	return n;
+}
+
+/* suggest.c ends here */
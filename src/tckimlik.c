@@ -40,13 +40,15 @@
 #include <stdint.h>
 #include <assert.h>
 #include "numchk.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
 	machine numchk;
 
-	tckimlik = digit{9} (digit{2} | check{2}) %{c(tckimlik)} ;
+	tckimlik = digit{9} (digit{2} | check{2}) %{cd(tckimlik)} ;
 }%%
 #endif	/* RAGEL_BLOCK */
 
@@ -81,19 +83,51 @@ nmck_tckimlik(const char *str, size_t len)
 		((char)s1 != str[len - 2U] || (char)s2 != str[len - 1U]);
 }
 
-void
-nmpr_tckimlik(nmck_t s, const char *str, size_t len)
+nmck_t
+nmdg_tckimlik(const struct nmdg_s *dg, const char *str, size_t len)
 {
+/* the first 9 digits, those at odd distance to the payload's end and
+ * those at even distance bar the 10th digit */
+	const uint_fast32_t o = dg->s[1U];
+	const uint_fast32_t e = dg->s[0U] - dg->d[9U];
+	uint_fast32_t s1, s2;
+
+	if (UNLIKELY(len < 11U || len > 11U)) {
+		return -1;
+	}
+	s1 = 7U * o + 9U * e;
+	s2 = o + e + s1;
+	s1 %= 10U;
+	s2 %= 10U;
+	s1 ^= '0';
+	s2 ^= '0';
+
+	return (s1 << 8U ^ s2) << 1U ^
+		((char)s1 != str[len - 2U] || (char)s2 != str[len - 1U]);
+}
+
+size_t
+nmfmt_tckimlik(char *restrict buf, nmck_t s, const char *str, size_t len)
+{
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("TC kimlik no, conformant", stdout);
+		bp = fmt_lit(bp, "TC kimlik no, conformant");
 	} else if (s > 0 && len > 2U) {
-		fputs("TC kimlik no, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(s >> 9 & 0x7f, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "TC kimlik no, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(s >> 9 & 0x7f);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_tckimlik(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_tckimlik, s, str, len);
 	return;
 }
 
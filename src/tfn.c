@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -94,18 +95,27 @@ nmck_tfn(const char *str, size_t len)
 	return sum << 1U ^ (sum > 0);
 }
 
-void
-nmpr_tfn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_tfn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!s)) {
-		fputs("TFN, conformant", stdout);
+		bp = fmt_lit(bp, "TFN, conformant");
 	} else if (s > 0 && len > 0) {
-		fputs("TFN, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 1U, stdout);
-		fputc((s >> 1U & 0xfU) ^ '0', stdout);
+		bp = fmt_lit(bp, "TFN, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 1U);
+		*bp++ = (char)((s >> 1U & 0xfU) ^ '0');
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_tfn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_tfn, s, str, len);
 	return;
 }
 
@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -94,19 +95,29 @@ nmck_titulo_eleitoral(const char *str, size_t len)
 		((char)s1 != str[len - 2U] || (char)s2 != str[len - 1U]);
 }
 
-void
-nmpr_titulo_eleitoral(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_titulo_eleitoral(char *restrict buf, nmck_t s,
+		       const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (!(s & 0b1U)) {
-		fputs("Titulo Eleitoral, conformant", stdout);
+		bp = fmt_lit(bp, "Titulo Eleitoral, conformant");
 	} else if (s > 0 && len > 2U) {
-		fputs("Titulo Eleitoral, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), len - 2U, stdout);
-		fputc(s >> 9 & 0x7f, stdout);
-		fputc(s >> 1 & 0x7f, stdout);
+		bp = fmt_lit(bp, "Titulo Eleitoral, not conformant, should be ");
+		bp = fmt_mem(bp, str, len - 2U);
+		*bp++ = (char)(s >> 9 & 0x7f);
+		*bp++ = (char)(s >> 1 & 0x7f);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_titulo_eleitoral(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_titulo_eleitoral, s, str, len);
 	return;
 }
 
@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -76,18 +77,27 @@ nmck_upn(const char *str, size_t len)
 	return c << 1U ^ (str[0U] != (char)c);
 }
 
-void
-nmpr_upn(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_upn(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("UPN, conformant", stdout);
+		bp = fmt_lit(bp, "UPN, conformant");
 	} else if (s > 0 && len > 1U) {
-		fputs("UPN, not conformant, should be ", stdout);
-		fputc(s >> 1U & 0x7fU, stdout);
-		fwrite(str + 1U, sizeof(*str), len - 1U, stdout);
+		bp = fmt_lit(bp, "UPN, not conformant, should be ");
+		*bp++ = (char)(s >> 1U & 0x7fU);
+		bp = fmt_mem(bp, str + 1U, len - 1U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_upn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_upn, s, str, len);
 	return;
 }
 
@@ -38,7 +38,10 @@
 #include <string.h>
 #include <stdio.h>
 #include "numchk.h"
+#include "state.h"
+#include "digits.h"
 #include "nifty.h"
+#include "fmt.h"
 
 static const uint_fast8_t d5[10U][10U] = {
 	[0] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
@@ -84,13 +87,73 @@ nmck_verhoeff(const char *str, size_t len)
 	return !prod - 1;
 }
 
-void
-nmpr_verhoeff(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+unsigned int
+verhoeff_prod(const unsigned char *d, size_t n)
+{
+/* as if a check digit followed */
+	uint_fast8_t prod = 0U;
+
+	for (size_t i = n, j = 1U; i > 0U; i--) {
+		prod = d5[prod][perm[j++ % 8U][d[i - 1U]]];
+	}
+	return prod;
+}
+
+nmck_t
+nmdg_verhoeff(const struct nmdg_s *dg,
+	      const char *UNUSED(str), size_t UNUSED(len))
+{
+/* products associate, so the check digit can go in front */
+	return !d5[dg->d[dg->n - 1U]][dg->vp] - 1;
+}
+
+size_t
+nmfmt_verhoeff(char *restrict buf, nmck_t s,
+	       const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (!s) {
-		fputs("Verhoeff secured number, check passed", stdout);
+		bp = fmt_lit(bp, "Verhoeff secured number, check passed");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_verhoeff(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_verhoeff, s, str, len);
 	return;
 }
 
+
+/* incremental, the permutation applied to a digit depends on its
+ * distance to the end which isn't known in advance, so S[J] is the
+ * product as if every digit were J places further from the end, then
+ * a new last digit goes in front of the products shifted by one */
+int
+verhoeff_feed(struct nmck_state *st, char c)
+{
+	const uint_fast8_t d = (unsigned char)(c ^ '0');
+	unsigned int s[8U];
+
+	if (UNLIKELY(d >= 10U)) {
+		return -1;
+	}
+	for (size_t j = 0U; j < 8U; j++) {
+		s[j] = d5[perm[j][d]][st->s[(j + 1U) % 8U]];
+	}
+	memcpy(st->s, s, sizeof(s));
+	return 0;
+}
+
+int
+verhoeff_final(const struct nmck_state *st)
+{
+	if (st->len < 2U) {
+		return -1;
+	}
+	return st->s[0U] != 0U;
+}
+
 /* verhoeff.c ends here */
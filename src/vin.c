@@ -40,6 +40,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -93,19 +94,28 @@ nmck_vin(const char *str, size_t len)
 	return sum << 1U ^ (str[8U] != (char)sum);
 }
 
-void
-nmpr_vin(nmck_t s, const char *str, size_t len)
+size_t
+nmfmt_vin(char *restrict buf, nmck_t s, const char *str, size_t len)
 {
+	char *bp = buf;
+
 	if (LIKELY(!(s & 0b1U))) {
-		fputs("VIN, conformant", stdout);
+		bp = fmt_lit(bp, "VIN, conformant");
 	} else if (s > 0 && len > 8U) {
-		fputs("VIN, not conformant, should be ", stdout);
-		fwrite(str, sizeof(*str), 8U, stdout);
-		fputc(s >> 1U & 0x7FU, stdout);
-		fwrite(str + 9U, sizeof(*str), len - 9U, stdout);
+		bp = fmt_lit(bp, "VIN, not conformant, should be ");
+		bp = fmt_mem(bp, str, 8U);
+		*bp++ = (char)(s >> 1U & 0x7FU);
+		bp = fmt_mem(bp, str + 9U, len - 9U);
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_vin(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_vin, s, str, len);
 	return;
 }
 
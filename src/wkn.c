@@ -41,6 +41,7 @@
 #include <assert.h>
 #include "numchk.h"
 #include "nifty.h"
+#include "fmt.h"
 
 #ifdef RAGEL_BLOCK
 %%{
@@ -84,16 +85,26 @@ nmck_wkn(const char *str, size_t len)
 	return 0;
 }
 
-void
-nmpr_wkn(nmck_t s, const char *UNUSED(str), size_t UNUSED(len))
+size_t
+nmfmt_wkn(char *restrict buf, nmck_t s,
+	  const char *UNUSED(str), size_t UNUSED(len))
 {
+	char *bp = buf;
+
 	if (!s) {
-		fputs("WKN, conformant", stdout);
+		bp = fmt_lit(bp, "WKN, conformant");
 	} else if (s > 0) {
-		fputs("WKN, not conformant", stdout);
+		bp = fmt_lit(bp, "WKN, not conformant");
 	} else {
-		fputs("unknown", stdout);
+		bp = fmt_lit(bp, "unknown");
 	}
+	return bp - buf;
+}
+
+void
+nmpr_wkn(nmck_t s, const char *str, size_t len)
+{
+	nmpr_fmt(nmfmt_wkn, s, str, len);
 	return;
 }
 
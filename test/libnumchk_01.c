@@ -0,0 +1,275 @@
+/*** libnumchk_01.c -- exercise libnumchk as a library
+ *
+ * Copyright (C) 2014-2018 Sebastian Freundt
+ *
+ * Author:  Sebastian Freundt <freundt@ga-group.nl>
+ *
+ * This file is part of numchk.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the author nor the names of any contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***/
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "numchk.h"
+#include "nifty.h"
+
+/* inputs to classify, the lines of stdin up to their first tab, plus
+ * some junk that shouldn't be classified as anything */
+static char *buf;
+static int32_t *off;
+static size_t n;
+
+static const char *const junk[] = {
+	"", "-", "??", "__", "foo", "hello world", "----",
+	"0000000000000000000000000000000000000000000000000000000000000",
+};
+
+static int rc;
+
+static void
+fail(const char *what, size_t i)
+{
+	fprintf(stderr, "%s: input %zu `%.*s'\n", what, i,
+		(int)(off[i + 1U] - off[i]), buf + off[i]);
+	rc = 1;
+	return;
+}
+
+static int
+rd_inputs(FILE *fp)
+{
+	size_t bz = 0U, nz = 0U;
+	char *line = NULL;
+	size_t llen = 0U;
+	ssize_t nrd = 0;
+
+	while ((nrd >= 0 && (nrd = getline(&line, &llen, fp)) > 0) ||
+	       nz < countof(junk)) {
+		const char *s = nrd > 0 ? line : junk[nz++];
+		const size_t z = strcspn(s, "\t\n");
+
+		buf = realloc(buf, bz + z + 1U);
+		off = realloc(off, (n + 2U) * sizeof(*off));
+		memcpy(buf + bz, s, z);
+		off[n++] = (int32_t)bz;
+		off[n] = (int32_t)(bz += z);
+	}
+	free(line);
+	return n > 0U ? 0 : -1;
+}
+
+
+/* batch classification against one nmck_classify() per input */
+static int
+cmp_res(const struct nmck_result *a, size_t na,
+	const struct nmck_result *b, size_t nb)
+{
+	if (na != nb) {
+		return -1;
+	}
+	for (size_t j = 0U; j < na; j++) {
+		if (a[j].type != b[j].type ||
+		    a[j].status != b[j].status ||
+		    a[j].sure != b[j].sure ||
+		    a[j].state != b[j].state) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+chk_batch(const struct nmck_result *ref, const size_t *roff, size_t nres)
+{
+/* classify everything in a result column of NRES entries, again and
+ * again as long as there are inputs left */
+	struct nmck_result *res = calloc(nres, sizeof(*res));
+	int32_t *ro = calloc(n + 1U, sizeof(*ro));
+
+	for (size_t i = 0U, k; i < n; i += k) {
+		k = nmck_classify_batch(buf, off + i, n - i, res, nres, ro);
+
+		for (size_t j = 0U; j < k; j++) {
+			if (cmp_res(res + ro[j], ro[j + 1U] - ro[j],
+				    ref + roff[i + j],
+				    roff[i + j + 1U] - roff[i + j]) < 0) {
+				fail("batch and single results differ", i + j);
+			}
+		}
+		if (i + k < n &&
+		    (size_t)ro[k] + roff[i + k + 1U] - roff[i + k] <= nres) {
+			/* there'd have been room for the next one */
+			fail("batch stopped short", i + k);
+		} else if (!k) {
+			/* the next input won't fit in an empty column */
+			break;
+		}
+	}
+	free(res);
+	free(ro);
+	return;
+}
+
+
+/* incremental check digits against the checkers */
+static const struct {
+	nmck_algo_t algo;
+	nmck_t(*chck)(const char*, size_t);
+	const char *str;
+	/* alternatives for the last character */
+	const char *alt;
+} stv[] = {
+	{NMCK_ALGO_LUHN, nmck_luhn, "79927398713", "0123456789"},
+	{NMCK_ALGO_MOD10_31, nmck_gtin, "4006381333931", "0123456789"},
+	{NMCK_ALGO_MOD11, nmck_isbn10, "0-306-40615-2", "0123456789X"},
+	{NMCK_ALGO_MOD97, nmck_lei, "529900T8BM49AURSDO55", "0123456789"},
+	{NMCK_ALGO_MOD97_ROT4, nmck_iban,
+	 "GB82WEST12345698765432", "0123456789"},
+	{NMCK_ALGO_DAMM10, nmck_damm10, "5724", "0123456789"},
+	{NMCK_ALGO_DAMM16, nmck_damm16, "1234AB27", "0123456789ABCDEF"},
+	{NMCK_ALGO_VERHOEFF, nmck_aadhaar, "234123412346", "0123456789"},
+};
+
+static void
+chk_state(void)
+{
+	char s[64U];
+
+	for (size_t i = 0U; i < countof(stv); i++) {
+		const size_t z = strlen(stv[i].str);
+
+		memcpy(s, stv[i].str, z);
+		for (const char *c = stv[i].alt; *c; c++) {
+			struct nmck_state st[1U];
+			nmck_t x;
+			int f;
+
+			s[z - 1U] = *c;
+			nmck_state_init(st, stv[i].algo);
+			for (size_t j = 0U; j < z; j++) {
+				nmck_state_feed(st, s[j]);
+			}
+			f = nmck_state_final(st);
+			x = stv[i].chck(s, z);
+			if ((f == 0) != (x >= 0 && !(x & 1))) {
+				fprintf(stderr, "\
+state and checker disagree on `%.*s'\n", (int)z, s);
+				rc = 1;
+			}
+		}
+	}
+	return;
+}
+
+
+/* completion with and without a list of types */
+static void
+chk_cmpl(void)
+{
+	static const nmck_type_t isin[] = {NMCK_isin};
+	static const nmck_type_t lei[] = {NMCK_lei};
+	static const struct {
+		const char *str;
+		const nmck_type_t *ty;
+		size_t nty;
+		nmck_type_t t;
+		const char *exp;
+	} cv[] = {
+		{"US037833100_", isin, countof(isin), NMCK_isin, "US0378331005"},
+		{"US037833100_", NULL, 0U, NMCK_isin, "US0378331005"},
+		{"US037833100_", lei, countof(lei), NMCK_UNK, "US037833100_"},
+		{"US0378331005", isin, countof(isin), NMCK_UNK, "US0378331005"},
+		{"529900T8BM49AURSDO__", lei, countof(lei),
+		 NMCK_lei, "529900T8BM49AURSDO55"},
+	};
+	char s[64U];
+
+	for (size_t i = 0U; i < countof(cv); i++) {
+		const size_t z = strlen(cv[i].str);
+		nmck_type_t t;
+
+		memcpy(s, cv[i].str, z);
+		t = nmck_complete(s, z, cv[i].ty, cv[i].nty);
+		if (t != cv[i].t || memcmp(s, cv[i].exp, z)) {
+			fprintf(stderr, "\
+completion of `%s' gives %s `%.*s'\n",
+				cv[i].str, nmck_type_name(t), (int)z, s);
+			rc = 1;
+		}
+	}
+	return;
+}
+
+
+int
+main(void)
+{
+	struct nmck_result *ref;
+	size_t *roff;
+	size_t nref = 0U;
+	size_t mx = 0U;
+
+	if (rd_inputs(stdin) < 0) {
+		return 1;
+	}
+
+	/* the reference, one input at a time */
+	ref = calloc(n * NMCK_NTYPES, sizeof(*ref));
+	roff = calloc(n + 1U, sizeof(*roff));
+	for (size_t i = 0U; i < n; i++) {
+		const size_t m = nmck_classify(
+			buf + off[i], off[i + 1U] - off[i], ref + nref);
+
+		roff[i + 1U] = nref += m;
+		mx = m > mx ? m : mx;
+	}
+
+	/* room for everything, then room for less than all checkers
+	 * so the scratch column is used, then just enough for the
+	 * input with the most results, then too little for it */
+	chk_batch(ref, roff, n * NMCK_NTYPES);
+	chk_batch(ref, roff, NMCK_NTYPES + 1U);
+	chk_batch(ref, roff, mx);
+	if (mx > 1U) {
+		chk_batch(ref, roff, mx - 1U);
+	}
+
+	chk_state();
+	chk_cmpl();
+
+	free(ref);
+	free(roff);
+	free(buf);
+	free(off);
+	return rc;
+}
+
+/* libnumchk_01.c ends here */
@@ -0,0 +1,13 @@
+## one line per result of numchk --json, the input and the result object,
+## only results of type T if given
+{
+	inp = $0
+	sub(/,"results":.*/, "", inp)
+	for (s = $0; match(s, /\{"type":"[^"]*"[^}]*\}/); ) {
+		r = substr(s, RSTART, RLENGTH)
+		s = substr(s, RSTART + RLENGTH)
+		if (t == "" || index(r, "{\"type\":\"" t "\"") == 1) {
+			print inp "\t" r
+		}
+	}
+}